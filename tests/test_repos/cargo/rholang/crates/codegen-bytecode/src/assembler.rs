@@ -20,6 +20,13 @@ impl Assembler {
     }
 
     pub fn assemble(&mut self, module: &IrModule) -> Vec<u8> {
+        // Each module is assembled from scratch, so one assembler can be
+        // reused across compilations
+        self.instructions.clear();
+        self.labels.clear();
+        self.variables.clear();
+        self.next_var = 0;
+
         for function in &module.functions {
             self.assemble_function(function);
         }
@@ -35,6 +42,12 @@ impl Assembler {
     }
 
     fn assemble_function(&mut self, function: &IrFunction) {
+        // Parameters take the first local slots, in order, so callers can
+        // bind inputs to the entry function by position
+        for param in &function.params {
+            self.get_or_create_var(&param.name);
+        }
+
         for block in &function.blocks {
             self.assemble_block(block);
         }
@@ -230,4 +243,13 @@ mod tests {
         let idx3 = assembler.get_or_create_var("y");
         assert_ne!(idx1, idx3);
     }
+
+    #[test]
+    fn test_assembler_reuse() {
+        let mut assembler = Assembler::new();
+        let module = IrModule::new("test".to_string());
+        let first = assembler.assemble(&module);
+        let second = assembler.assemble(&module);
+        assert_eq!(first, second);
+    }
 }
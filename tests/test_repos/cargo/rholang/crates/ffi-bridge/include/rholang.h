@@ -17,21 +17,104 @@ extern "C" {
 int rholang_native_init(void);
 void rholang_native_cleanup(void);
 
-/* Memory management */
+/*
+ * Memory management
+ *
+ * Blocks come from per-thread size-class pools. rholang_native_alloc and
+ * rholang_native_calloc return zeroed memory; rholang_native_alloc_uninit
+ * skips the zeroing for callers that overwrite the block anyway. All of
+ * them are released with rholang_native_free, from any thread.
+ */
 void* rholang_native_alloc(size_t size);
+void* rholang_native_alloc_uninit(size_t size);
+void* rholang_native_calloc(size_t count, size_t size);
 void rholang_native_free(void* ptr);
 
+/*
+ * Allocator statistics. Each thread publishes its counters whenever it
+ * touches the shared pool and when it exits, so a snapshot may trail the
+ * latest activity of other threads.
+ */
+typedef struct {
+    uint64_t allocations;       /* successful allocations */
+    uint64_t frees;
+    uint64_t bytes_in_use;      /* requested bytes not yet freed */
+    uint64_t cache_hits;        /* served from the thread's own cache */
+    uint64_t cache_misses;      /* refilled from the shared pool or malloc */
+    uint64_t large_allocations; /* above the largest size class */
+    uint64_t failures;
+    uint64_t pooled_blocks;     /* free blocks parked in the shared pool */
+} rholang_alloc_stats_t;
+
+void rholang_native_alloc_stats(rholang_alloc_stats_t* stats);
+
+/*
+ * Length-delimited strings: ptr need not be NUL-terminated, so callers can
+ * pass borrowed (e.g. Rust-owned) buffers. Functions taking (ptr, len)
+ * never keep the pointer. Apart from the copy functions they only allocate
+ * for names or paths too long for a stack buffer (256 and 4096 bytes).
+ */
+typedef struct {
+    const char* ptr;
+    size_t len;
+} rholang_str_t;
+
 /* System utilities */
 const char* rholang_native_getenv(const char* name);
+const char* rholang_native_getenv_n(const char* name, size_t len);
 int rholang_native_file_exists(const char* path);
+int rholang_native_file_exists_n(const char* path, size_t len);
+
+/*
+ * Existence cache for module resolution: remembers each probed path's
+ * answer, including misses. Files created or removed after a probe are
+ * only noticed after rholang_native_file_cache_clear. Off by default.
+ */
+void rholang_native_file_cache_enable(int enabled);
+void rholang_native_file_cache_clear(void);
 
 /* Callback support for Rust -> C -> Rust */
 typedef void (*rholang_callback_t)(int value);
 void rholang_native_set_callback(rholang_callback_t callback);
 void rholang_native_trigger_callback(int value);
 
-/* String utilities */
+/*
+ * Batched callbacks: up to 8 subscribers, each called once per batch with
+ * its own context pointer. rholang_native_subscribe returns a subscription
+ * id, or -1 if the callback is NULL or the table is full.
+ */
+typedef void (*rholang_batch_callback_t)(const int* values, size_t count, void* ctx);
+int rholang_native_subscribe(rholang_batch_callback_t callback, void* ctx);
+void rholang_native_unsubscribe(int subscription);
+void rholang_native_trigger_batch(const int* values, size_t count);
+
+/*
+ * Buffered delivery: triggered values are queued in a lock-free ring of at
+ * least capacity slots and delivered in batches once flush_count are
+ * pending (0 = half the ring), every flush_interval_ms (0 = no timer), on
+ * rholang_native_buffer_flush, and when buffering stops. Returns 0, -1 if
+ * already buffering (or another thread is starting or stopping it) or
+ * unsupported on this platform, -2 on allocation failure.
+ *
+ * Subscribers may trigger values from a buffered delivery: they are queued
+ * and delivered before that flush returns, or straight away if the ring is
+ * full. From a subscriber, rholang_native_buffer_flush does nothing and
+ * rholang_native_buffer_stop is ignored.
+ */
+int rholang_native_buffer_start(size_t capacity, size_t flush_count, unsigned flush_interval_ms);
+void rholang_native_buffer_flush(void);
+void rholang_native_buffer_stop(void);
+
+/* String utilities; the copies are released with rholang_native_free */
 char* rholang_native_string_copy(const char* str);
+char* rholang_native_string_copy_n(const char* str, size_t len);
+
+/*
+ * Copy len bytes plus a terminator into out without allocating. Returns
+ * len; if that is >= out_size nothing is copied (out is emptied), so retry
+ * with at least len + 1 bytes.
+ */
+size_t rholang_native_string_copy_into(const char* str, size_t len, char* out, size_t out_size);
 
 /* Error handling */
 const char* rholang_native_error_string(int error_code);
@@ -44,7 +127,14 @@ const char* rholang_native_error_string(int error_code);
 /* Initialize RhoLang runtime from C */
 int rholang_runtime_init(void);
 
-/* Execute RhoLang code from C */
+/*
+ * Execute RhoLang code from C. Compiled programs are cached by source
+ * text in a process-wide session, so repeating a snippet only re-runs it;
+ * the cache holds up to 256 programs and starts over when full. All
+ * callers share that session behind one global lock, held through both
+ * compile and VM run, so concurrent calls run one at a time. Threads that
+ * need to run in parallel should each use their own rholang_session_t.
+ */
 int rholang_execute_code(const char* source_code, size_t len);
 
 /* Shutdown RhoLang runtime from C */
@@ -53,6 +143,54 @@ void rholang_runtime_shutdown(void);
 /* Get version information */
 const char* rholang_get_version(void);
 
+/*
+ * Sessions: compile once, run many times on one warmed VM. A session is
+ * not thread-safe; give each thread its own. Program ids are non-zero and
+ * compiling the same source again returns the cached id.
+ */
+typedef struct rholang_session rholang_session_t;
+
+rholang_session_t* rholang_session_create(void);
+void rholang_session_destroy(rholang_session_t* session);
+
+/* Returns a program id, or 0 with the reason in rholang_session_last_error */
+uint32_t rholang_session_compile(rholang_session_t* session, const char* source, size_t len);
+
+/*
+ * Run a program with inputs bound to its entry function's parameters, in
+ * order. Returns 0 and stores the result (if non-NULL), or -1 on error.
+ */
+int rholang_session_run(rholang_session_t* session, uint32_t program,
+                        const int64_t* inputs, size_t input_count, int64_t* result);
+
+/*
+ * Run a program once per row of inputs (runs rows of inputs_per_run
+ * values), writing results[i] for row i. Stops at the first failing run;
+ * returns the number of runs completed.
+ */
+size_t rholang_session_run_many(rholang_session_t* session, uint32_t program,
+                                const int64_t* inputs, size_t inputs_per_run,
+                                size_t runs, int64_t* results);
+
+/*
+ * Compile (with caching) and run each source once. results and statuses
+ * (0 or -1 per source) may be NULL. Returns the number that succeeded.
+ */
+size_t rholang_session_execute_batch(rholang_session_t* session,
+                                     const rholang_str_t* sources, size_t count,
+                                     int64_t* results, int* statuses);
+
+/* Last error on this session, valid until its next failing call */
+const char* rholang_session_last_error(const rholang_session_t* session);
+
+/*
+ * Interned identifiers, backed by the span-interner crate. Equal strings
+ * get equal non-zero ids; 0 means NULL or invalid UTF-8. Resolved views
+ * are not NUL-terminated and stay valid for the life of the process.
+ */
+uint32_t rholang_intern(const char* str, size_t len);
+rholang_str_t rholang_intern_resolve(uint32_t id);
+
 #ifdef __cplusplus
 }
 #endif
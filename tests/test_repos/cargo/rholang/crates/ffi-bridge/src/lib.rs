@@ -1,18 +1,77 @@
+pub mod session;
+
+pub use session::Session;
+
 use vm_runtime::{Runtime, VMError};
 use common_types::Span;
-use std::ffi::{CStr, CString};
+use span_interner::{InternedString, SpanInterner};
+use std::ffi::CStr;
 use std::os::raw::{c_char, c_int, c_void};
+use std::sync::{Mutex, OnceLock};
+
+/// Mirror of `rholang_alloc_stats_t` in rholang.h
+#[repr(C)]
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct AllocStats {
+    pub allocations: u64,
+    pub frees: u64,
+    pub bytes_in_use: u64,
+    pub cache_hits: u64,
+    pub cache_misses: u64,
+    pub large_allocations: u64,
+    pub failures: u64,
+    pub pooled_blocks: u64,
+}
+
+/// Mirror of `rholang_str_t` in rholang.h: a borrowed, unterminated string
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct RholangStr {
+    pub ptr: *const c_char,
+    pub len: usize,
+}
+
+impl RholangStr {
+    pub fn from_str(s: &str) -> Self {
+        Self {
+            ptr: s.as_ptr() as *const c_char,
+            len: s.len(),
+        }
+    }
+
+    pub fn null() -> Self {
+        Self {
+            ptr: std::ptr::null(),
+            len: 0,
+        }
+    }
+}
 
 // External C functions from native.c (Rust -> C)
 extern "C" {
     fn rholang_native_init() -> c_int;
     fn rholang_native_cleanup();
     fn rholang_native_alloc(size: usize) -> *mut c_void;
+    fn rholang_native_alloc_uninit(size: usize) -> *mut c_void;
     fn rholang_native_free(ptr: *mut c_void);
-    fn rholang_native_getenv(name: *const c_char) -> *const c_char;
-    fn rholang_native_file_exists(path: *const c_char) -> c_int;
+    fn rholang_native_alloc_stats(stats: *mut AllocStats);
+    fn rholang_native_string_copy_n(str: *const c_char, len: usize) -> *mut c_char;
+    fn rholang_native_getenv_n(name: *const c_char, len: usize) -> *const c_char;
+    fn rholang_native_file_exists_n(path: *const c_char, len: usize) -> c_int;
+    fn rholang_native_file_cache_enable(enabled: c_int);
+    fn rholang_native_file_cache_clear();
+    fn rholang_native_subscribe(callback: BatchCallback, ctx: *mut c_void) -> c_int;
+    fn rholang_native_unsubscribe(subscription: c_int);
+    fn rholang_native_trigger_batch(values: *const c_int, count: usize);
+    fn rholang_native_trigger_callback(value: c_int);
+    fn rholang_native_buffer_start(capacity: usize, flush_count: usize, flush_interval_ms: u32) -> c_int;
+    fn rholang_native_buffer_flush();
+    fn rholang_native_buffer_stop();
 }
 
+/// `rholang_batch_callback_t`: a batch of values plus the subscriber's context
+pub type BatchCallback = extern "C" fn(values: *const c_int, count: usize, ctx: *mut c_void);
+
 pub struct FFIBridge {
     runtime: Runtime,
     initialized: bool,
@@ -29,19 +88,32 @@ impl FFIBridge {
         }
     }
 
-    /// Call native C function to check if file exists
+    /// Call native C function to check if file exists; the path is
+    /// borrowed as-is, with no CString copy
     pub fn native_file_exists(&self, path: &str) -> bool {
-        let c_path = CString::new(path).unwrap();
         unsafe {
-            rholang_native_file_exists(c_path.as_ptr()) != 0
+            rholang_native_file_exists_n(path.as_ptr() as *const c_char, path.len()) != 0
+        }
+    }
+
+    /// Cache existence checks for module resolution (see rholang.h)
+    pub fn set_file_cache(&self, enabled: bool) {
+        unsafe {
+            rholang_native_file_cache_enable(enabled as c_int);
+        }
+    }
+
+    /// Forget cached existence checks after files were created or removed
+    pub fn clear_file_cache(&self) {
+        unsafe {
+            rholang_native_file_cache_clear();
         }
     }
 
     /// Get environment variable via native C function
     pub fn native_getenv(&self, name: &str) -> Option<String> {
-        let c_name = CString::new(name).unwrap();
         unsafe {
-            let result = rholang_native_getenv(c_name.as_ptr());
+            let result = rholang_native_getenv_n(name.as_ptr() as *const c_char, name.len());
             if result.is_null() {
                 None
             } else {
@@ -50,6 +122,15 @@ impl FFIBridge {
         }
     }
 
+    /// Snapshot of the native pooled allocator's counters
+    pub fn native_alloc_stats(&self) -> AllocStats {
+        let mut stats = AllocStats::default();
+        unsafe {
+            rholang_native_alloc_stats(&mut stats);
+        }
+        stats
+    }
+
     pub fn execute_bytecode(&mut self, bytecode: &[u8]) -> Result<i64, String> {
         match self.runtime.execute(bytecode) {
             Ok(Some(codegen_bytecode::instruction::Value::Int(i))) => Ok(i),
@@ -117,7 +198,8 @@ pub extern "C" fn rholang_execute(
 
 #[no_mangle]
 pub extern "C" fn rholang_runtime_init() -> c_int {
-    // Initialize global runtime
+    // Warm the session that rholang_execute_code compiles into
+    session::with_default_session(|_| ());
     0 // Success
 }
 
@@ -127,17 +209,14 @@ pub extern "C" fn rholang_execute_code(source_code: *const c_char, len: usize) -
         return -1;
     }
 
-    unsafe {
-        let code_slice = std::slice::from_raw_parts(source_code as *const u8, len);
-        // In a real implementation, would compile and execute the code
-        // For now, just return success
-        0
-    }
+    // Repeated sources hit the default session's compile cache
+    unsafe { session::execute_code(source_code, len) }
 }
 
 #[no_mangle]
 pub extern "C" fn rholang_runtime_shutdown() {
-    // Shutdown global runtime
+    // Drop the default session and everything it compiled
+    session::drop_default_session();
 }
 
 #[no_mangle]
@@ -146,6 +225,45 @@ pub extern "C" fn rholang_get_version() -> *const c_char {
     VERSION.as_ptr() as *const c_char
 }
 
+// Process-wide identifier table behind rholang_intern. Interned strings
+// are never removed, and each one's heap buffer stays put when the table
+// grows, so resolved views remain valid after the lock is released.
+fn interner() -> &'static Mutex<SpanInterner> {
+    static INTERNER: OnceLock<Mutex<SpanInterner>> = OnceLock::new();
+    INTERNER.get_or_init(|| Mutex::new(SpanInterner::new()))
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_intern(str: *const c_char, len: usize) -> u32 {
+    if str.is_null() {
+        return 0;
+    }
+
+    let bytes = unsafe { std::slice::from_raw_parts(str as *const u8, len) };
+    let Ok(s) = std::str::from_utf8(bytes) else {
+        return 0;
+    };
+
+    let mut table = interner().lock().unwrap_or_else(|e| e.into_inner());
+    match u32::try_from(table.intern(s).as_index() + 1) {
+        Ok(id) => id,
+        Err(_) => 0,
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_intern_resolve(id: u32) -> RholangStr {
+    if id == 0 {
+        return RholangStr::null();
+    }
+
+    let table = interner().lock().unwrap_or_else(|e| e.into_inner());
+    match table.resolve(InternedString::from_index(id as usize - 1)) {
+        Some(s) => RholangStr::from_str(s),
+        None => RholangStr::null(),
+    }
+}
+
 #[cfg(test)]
 mod tests {
     use super::*;
@@ -163,6 +281,44 @@ mod tests {
         rholang_destroy(bridge);
     }
 
+    #[test]
+    fn test_native_getenv_long_name() {
+        let bridge = FFIBridge::new();
+        let name = format!("RHOLANG_TEST_{}", "X".repeat(300));
+        std::env::set_var(&name, "long");
+        assert_eq!(bridge.native_getenv(&name).as_deref(), Some("long"));
+        std::env::remove_var(&name);
+    }
+
+    #[test]
+    fn test_native_file_cache() {
+        let bridge = FFIBridge::new();
+        bridge.set_file_cache(true);
+        assert!(!bridge.native_file_exists("/nonexistent/path"));
+        assert!(!bridge.native_file_exists("/nonexistent/path"));
+        assert!(bridge.native_file_exists("Cargo.toml"));
+        bridge.clear_file_cache();
+        assert!(bridge.native_file_exists("Cargo.toml"));
+        bridge.set_file_cache(false);
+    }
+
+    #[test]
+    fn test_intern_roundtrip() {
+        let name = "channel_name";
+        let id = rholang_intern(name.as_ptr() as *const c_char, name.len());
+        assert_ne!(id, 0);
+        assert_eq!(rholang_intern(name.as_ptr() as *const c_char, name.len()), id);
+
+        let view = rholang_intern_resolve(id);
+        let bytes = unsafe { std::slice::from_raw_parts(view.ptr as *const u8, view.len) };
+        assert_eq!(bytes, name.as_bytes());
+
+        assert!(rholang_intern_resolve(0).ptr.is_null());
+        assert_eq!(rholang_intern(std::ptr::null(), 0), 0);
+        let invalid = [0xffu8, 0xfe];
+        assert_eq!(rholang_intern(invalid.as_ptr() as *const c_char, invalid.len()), 0);
+    }
+
     #[test]
     fn test_native_file_exists() {
         let bridge = FFIBridge::new();
@@ -171,6 +327,171 @@ mod tests {
         assert!(!exists);
     }
 
+    #[test]
+    fn test_native_alloc_pooling() {
+        let bridge = FFIBridge::new();
+        let before = bridge.native_alloc_stats();
+        unsafe {
+            let zeroed = rholang_native_alloc(64) as *mut u8;
+            assert!(!zeroed.is_null());
+            let bytes = std::slice::from_raw_parts(zeroed, 64);
+            assert!(bytes.iter().all(|&b| b == 0));
+            rholang_native_free(zeroed as *mut c_void);
+
+            // Same size class again: served from this thread's cache
+            let reused = rholang_native_alloc_uninit(40);
+            assert!(!reused.is_null());
+            rholang_native_free(reused);
+        }
+        let after = bridge.native_alloc_stats();
+        assert!(after.allocations >= before.allocations + 2);
+        assert!(after.cache_hits > before.cache_hits);
+    }
+
+    #[test]
+    fn test_native_string_copy_pooled() {
+        let _bridge = FFIBridge::new();
+        let text = "module_path";
+        unsafe {
+            let copy = rholang_native_string_copy_n(text.as_ptr() as *const c_char, text.len());
+            assert!(!copy.is_null());
+            assert_eq!(CStr::from_ptr(copy).to_bytes(), text.as_bytes());
+            rholang_native_free(copy as *mut c_void);
+        }
+    }
+
+    // Subscribers and buffering are process-wide: tests that trigger values
+    // run one at a time
+    static CALLBACK_TEST_LOCK: Mutex<()> = Mutex::new(());
+
+    fn callback_test_guard() -> std::sync::MutexGuard<'static, ()> {
+        CALLBACK_TEST_LOCK.lock().unwrap_or_else(|e| e.into_inner())
+    }
+
+    extern "C" fn sum_values(values: *const c_int, count: usize, ctx: *mut c_void) {
+        let values = unsafe { std::slice::from_raw_parts(values, count) };
+        let total = unsafe { &*(ctx as *const std::sync::atomic::AtomicI64) };
+        let sum: i64 = values.iter().map(|&v| v as i64).sum();
+        total.fetch_add(sum, std::sync::atomic::Ordering::Relaxed);
+    }
+
+    #[test]
+    fn test_batched_callback_subscribers() {
+        use std::sync::atomic::{AtomicI64, Ordering};
+
+        let _guard = callback_test_guard();
+        let first = AtomicI64::new(0);
+        let second = AtomicI64::new(0);
+        unsafe {
+            let a = rholang_native_subscribe(sum_values, &first as *const _ as *mut c_void);
+            let b = rholang_native_subscribe(sum_values, &second as *const _ as *mut c_void);
+            assert!(a >= 0 && b >= 0 && a != b);
+
+            let values = [1, 2, 3, 4];
+            rholang_native_trigger_batch(values.as_ptr(), values.len());
+
+            rholang_native_unsubscribe(a);
+            rholang_native_unsubscribe(b);
+        }
+        assert_eq!(first.load(Ordering::Relaxed), 10);
+        assert_eq!(second.load(Ordering::Relaxed), 10);
+    }
+
+    #[cfg(not(windows))]
+    #[test]
+    fn test_buffered_many_producers() {
+        use std::sync::atomic::{AtomicI64, Ordering};
+
+        let _guard = callback_test_guard();
+        let total = AtomicI64::new(0);
+        unsafe {
+            let sub = rholang_native_subscribe(sum_values, &total as *const _ as *mut c_void);
+            assert!(sub >= 0);
+            // A small ring, so producers also hit the full-ring fallback
+            assert_eq!(rholang_native_buffer_start(64, 0, 0), 0);
+            assert_eq!(rholang_native_buffer_start(64, 0, 0), -1);
+
+            std::thread::scope(|scope| {
+                for _ in 0..8 {
+                    scope.spawn(|| {
+                        for value in 1..=1000 {
+                            rholang_native_trigger_callback(value);
+                        }
+                    });
+                }
+            });
+            rholang_native_buffer_stop();
+            rholang_native_unsubscribe(sub);
+        }
+        assert_eq!(total.load(Ordering::Relaxed), 8 * 500_500);
+    }
+
+    #[cfg(not(windows))]
+    #[test]
+    fn test_buffered_interval_flush() {
+        use std::sync::atomic::{AtomicI64, Ordering};
+        use std::time::{Duration, Instant};
+
+        let _guard = callback_test_guard();
+        let total = AtomicI64::new(0);
+        unsafe {
+            let sub = rholang_native_subscribe(sum_values, &total as *const _ as *mut c_void);
+            assert!(sub >= 0);
+            // Too few values to reach flush_count: only the timer delivers
+            assert_eq!(rholang_native_buffer_start(1024, 1024, 5), 0);
+            let values = [1, 2, 3];
+            rholang_native_trigger_batch(values.as_ptr(), values.len());
+
+            let deadline = Instant::now() + Duration::from_secs(5);
+            while total.load(Ordering::Relaxed) != 6 && Instant::now() < deadline {
+                std::thread::sleep(Duration::from_millis(1));
+            }
+            let delivered = total.load(Ordering::Relaxed);
+            rholang_native_buffer_stop();
+            rholang_native_unsubscribe(sub);
+            assert_eq!(delivered, 6);
+        }
+    }
+
+    // Triggers, flushes and stops from inside its own delivery
+    extern "C" fn reentrant_values(values: *const c_int, count: usize, ctx: *mut c_void) {
+        sum_values(values, count, ctx);
+        let values = unsafe { std::slice::from_raw_parts(values, count) };
+        if values.contains(&1) {
+            unsafe {
+                rholang_native_trigger_callback(100);
+                rholang_native_buffer_flush();
+                rholang_native_buffer_stop();
+            }
+        }
+    }
+
+    #[cfg(not(windows))]
+    #[test]
+    fn test_buffered_reentrant_subscriber() {
+        use std::sync::atomic::{AtomicI64, Ordering};
+
+        let _guard = callback_test_guard();
+        let total = AtomicI64::new(0);
+        unsafe {
+            let sub = rholang_native_subscribe(reentrant_values, &total as *const _ as *mut c_void);
+            assert!(sub >= 0);
+            assert_eq!(rholang_native_buffer_start(64, 0, 0), 0);
+
+            // The value queued from the subscriber arrives before flush returns
+            rholang_native_trigger_callback(1);
+            rholang_native_buffer_flush();
+            assert_eq!(total.load(Ordering::Relaxed), 101);
+
+            // The stop from the subscriber was ignored: still buffering
+            rholang_native_trigger_callback(5);
+            assert_eq!(total.load(Ordering::Relaxed), 101);
+            rholang_native_buffer_stop();
+            assert_eq!(total.load(Ordering::Relaxed), 106);
+            rholang_native_unsubscribe(sub);
+        }
+    }
+
     #[test]
     fn test_version_export() {
         unsafe {
@@ -3,11 +3,383 @@
  * Demonstrates Rust -> C and C -> Rust interoperability
  */
 
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "../include/rholang.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#define access _access
+#define F_OK 0
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Spin lock for the short critical sections below. A waiter that keeps
+ * missing yields its time slice, so a holder preempted mid-section can run
+ * and release instead of being starved by spinning threads.
+ */
+
+#define NATIVE_SPIN_TRIES   64
+
+static void native_spin_lock(atomic_int* lock) {
+    int tries = 0;
+    while (atomic_exchange_explicit(lock, 1, memory_order_acquire)) {
+        if (++tries < NATIVE_SPIN_TRIES) {
+            continue;
+        }
+        tries = 0;
+#ifdef _WIN32
+        SwitchToThread();
+#else
+        sched_yield();
+#endif
+    }
+}
+
+static void native_spin_unlock(atomic_int* lock) {
+    atomic_store_explicit(lock, 0, memory_order_release);
+}
+
+/*
+ * Pooled allocator
+ *
+ * Requests up to 4 KB are rounded up to a power-of-two size class and served
+ * from a per-thread free list, so the common alloc/free pair never touches a
+ * lock. A thread cache that runs dry takes a batch of blocks from the shared
+ * per-class depot (or mallocs a fresh block); one that grows past its limit
+ * hands a batch back. Larger requests go straight to malloc. Every block
+ * carries a small header recording its class and requested size.
+ */
+
+#define POOL_MIN_SHIFT      4                   /* smallest class: 16 bytes */
+#define POOL_CLASSES        9                   /* 16 B .. 4 KB */
+#define POOL_MAX_SIZE       ((size_t)1 << (POOL_MIN_SHIFT + POOL_CLASSES - 1))
+#define POOL_CACHE_LIMIT    64                  /* blocks per class per thread */
+#define POOL_TRANSFER_BATCH 32                  /* blocks moved per depot trip */
+#define POOL_DEPOT_LIMIT    1024                /* blocks per class kept shared */
+#define POOL_LARGE_CLASS    UINT32_MAX
+
+/* 16 bytes keeps the payload aligned for any fundamental type */
+typedef struct {
+    size_t size;
+    uint32_t size_class;
+    uint32_t reserved;
+} pool_header_t;
+
+#define POOL_HEADER_SIZE 16
+
+typedef struct pool_block {
+    struct pool_block* next;
+} pool_block_t;
+
+typedef struct {
+    atomic_int lock;
+    pool_block_t* head;
+    size_t count;
+} pool_depot_t;
+
+/* Per-thread counters, published to the globals on depot trips and exit */
+typedef struct {
+    int64_t allocations;
+    int64_t frees;
+    int64_t bytes_in_use;
+    int64_t cache_hits;
+    int64_t cache_misses;
+    int64_t large_allocations;
+    int64_t failures;
+} pool_counters_t;
+
+typedef struct {
+    pool_block_t* head[POOL_CLASSES];
+    uint32_t count[POOL_CLASSES];
+    pool_counters_t counters;
+    int registered;
+} pool_thread_cache_t;
+
+static pool_depot_t pool_depots[POOL_CLASSES];
+
+static _Atomic int64_t pool_totals[sizeof(pool_counters_t) / sizeof(int64_t)];
+
+static _Thread_local pool_thread_cache_t pool_cache;
+
+static size_t pool_class_size(int size_class) {
+    return (size_t)1 << (POOL_MIN_SHIFT + size_class);
+}
+
+static int pool_size_class(size_t size) {
+    int size_class = 0;
+    while (pool_class_size(size_class) < size) {
+        size_class++;
+    }
+    return size_class;
+}
+
+/* Held only to splice a short list */
+static void pool_depot_lock(pool_depot_t* depot) {
+    native_spin_lock(&depot->lock);
+}
+
+static void pool_depot_unlock(pool_depot_t* depot) {
+    native_spin_unlock(&depot->lock);
+}
+
+static void pool_publish_counters(pool_thread_cache_t* cache) {
+    int64_t* local = (int64_t*)&cache->counters;
+    for (size_t i = 0; i < sizeof(pool_counters_t) / sizeof(int64_t); i++) {
+        if (local[i] != 0) {
+            atomic_fetch_add_explicit(&pool_totals[i], local[i], memory_order_relaxed);
+            local[i] = 0;
+        }
+    }
+}
+
+/* Move up to max blocks from the thread cache's class list to the depot */
+static void pool_spill(pool_thread_cache_t* cache, int size_class, uint32_t max) {
+    pool_block_t* first = cache->head[size_class];
+    if (first == NULL || max == 0) {
+        return;
+    }
+    pool_block_t* last = first;
+    uint32_t moved = 1;
+    while (moved < max && last->next != NULL) {
+        last = last->next;
+        moved++;
+    }
+    cache->head[size_class] = last->next;
+    cache->count[size_class] -= moved;
+
+    pool_depot_t* depot = &pool_depots[size_class];
+    pool_depot_lock(depot);
+    if (depot->count + moved <= POOL_DEPOT_LIMIT) {
+        last->next = depot->head;
+        depot->head = first;
+        depot->count += moved;
+        first = NULL;
+    } else {
+        last->next = NULL;
+    }
+    pool_depot_unlock(depot);
+
+    /* Depot full: give the batch back to the system */
+    while (first != NULL) {
+        pool_block_t* next = first->next;
+        free((char*)first - POOL_HEADER_SIZE);
+        first = next;
+    }
+}
+
+static void pool_flush_thread_cache(pool_thread_cache_t* cache) {
+    for (int size_class = 0; size_class < POOL_CLASSES; size_class++) {
+        pool_spill(cache, size_class, UINT32_MAX);
+    }
+    pool_publish_counters(cache);
+}
+
+#ifndef _WIN32
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t pool_key;
+
+static void pool_thread_exit(void* cache) {
+    pool_flush_thread_cache((pool_thread_cache_t*)cache);
+}
+
+static void pool_create_key(void) {
+    pthread_key_create(&pool_key, pool_thread_exit);
+}
+#endif
+
+/* Hook the thread cache up for flushing at thread exit */
+static void pool_register_thread(pool_thread_cache_t* cache) {
+    cache->registered = 1;
+#ifndef _WIN32
+    pthread_once(&pool_key_once, pool_create_key);
+    pthread_setspecific(pool_key, cache);
+#endif
+}
+
+/* Take a batch from the depot; returns the block to hand out or NULL */
+static pool_block_t* pool_refill(pool_thread_cache_t* cache, int size_class) {
+    pool_depot_t* depot = &pool_depots[size_class];
+    pool_block_t* first = NULL;
+    uint32_t taken = 0;
+
+    pool_depot_lock(depot);
+    if (depot->head != NULL) {
+        first = depot->head;
+        pool_block_t* last = first;
+        taken = 1;
+        while (taken < POOL_TRANSFER_BATCH && last->next != NULL) {
+            last = last->next;
+            taken++;
+        }
+        depot->head = last->next;
+        depot->count -= taken;
+        last->next = NULL;
+    }
+    pool_depot_unlock(depot);
+
+    pool_publish_counters(cache);
+    if (first == NULL) {
+        void* block = malloc(POOL_HEADER_SIZE + pool_class_size(size_class));
+        return block != NULL ? (pool_block_t*)((char*)block + POOL_HEADER_SIZE) : NULL;
+    }
+
+    cache->head[size_class] = first->next;
+    cache->count[size_class] = taken - 1;
+    return first;
+}
+
+void* rholang_native_alloc_uninit(size_t size) {
+    pool_thread_cache_t* cache = &pool_cache;
+    if (!cache->registered) {
+        pool_register_thread(cache);
+    }
+
+    pool_header_t* header;
+    if (size > POOL_MAX_SIZE) {
+        if (size > SIZE_MAX - POOL_HEADER_SIZE) {
+            cache->counters.failures++;
+            return NULL;
+        }
+        header = (pool_header_t*)malloc(POOL_HEADER_SIZE + size);
+        if (header == NULL) {
+            cache->counters.failures++;
+            return NULL;
+        }
+        header->size_class = POOL_LARGE_CLASS;
+        cache->counters.large_allocations++;
+    } else {
+        int size_class = pool_size_class(size);
+        pool_block_t* block = cache->head[size_class];
+        if (block != NULL) {
+            cache->head[size_class] = block->next;
+            cache->count[size_class]--;
+            cache->counters.cache_hits++;
+        } else {
+            cache->counters.cache_misses++;
+            block = pool_refill(cache, size_class);
+            if (block == NULL) {
+                cache->counters.failures++;
+                return NULL;
+            }
+        }
+        header = (pool_header_t*)((char*)block - POOL_HEADER_SIZE);
+        header->size_class = (uint32_t)size_class;
+    }
+
+    header->size = size;
+    cache->counters.allocations++;
+    cache->counters.bytes_in_use += (int64_t)size;
+    return (char*)header + POOL_HEADER_SIZE;
+}
+
+/* Memory allocation wrapper; the block is zeroed */
+void* rholang_native_alloc(size_t size) {
+    void* ptr = rholang_native_alloc_uninit(size);
+    if (ptr) {
+        memset(ptr, 0, size);
+    }
+    return ptr;
+}
+
+void* rholang_native_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        pool_cache.counters.failures++;
+        return NULL;
+    }
+    return rholang_native_alloc(count * size);
+}
+
+/* Memory deallocation wrapper */
+void rholang_native_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    pool_thread_cache_t* cache = &pool_cache;
+    if (!cache->registered) {
+        pool_register_thread(cache);
+    }
+
+    pool_header_t* header = (pool_header_t*)((char*)ptr - POOL_HEADER_SIZE);
+    cache->counters.frees++;
+    cache->counters.bytes_in_use -= (int64_t)header->size;
+
+    if (header->size_class == POOL_LARGE_CLASS) {
+        free(header);
+        return;
+    }
+
+    int size_class = (int)header->size_class;
+    pool_block_t* block = (pool_block_t*)ptr;
+    block->next = cache->head[size_class];
+    cache->head[size_class] = block;
+    if (++cache->count[size_class] > POOL_CACHE_LIMIT) {
+        pool_spill(cache, size_class, POOL_TRANSFER_BATCH);
+        pool_publish_counters(cache);
+    }
+}
+
+void rholang_native_alloc_stats(rholang_alloc_stats_t* stats) {
+    if (!stats) {
+        return;
+    }
+    pool_publish_counters(&pool_cache);
+
+    int64_t totals[sizeof(pool_counters_t) / sizeof(int64_t)];
+    for (size_t i = 0; i < sizeof(totals) / sizeof(totals[0]); i++) {
+        totals[i] = atomic_load_explicit(&pool_totals[i], memory_order_relaxed);
+    }
+    const pool_counters_t* counters = (const pool_counters_t*)totals;
+
+    stats->allocations = (uint64_t)counters->allocations;
+    stats->frees = (uint64_t)counters->frees;
+    stats->bytes_in_use = counters->bytes_in_use > 0 ? (uint64_t)counters->bytes_in_use : 0;
+    stats->cache_hits = (uint64_t)counters->cache_hits;
+    stats->cache_misses = (uint64_t)counters->cache_misses;
+    stats->large_allocations = (uint64_t)counters->large_allocations;
+    stats->failures = (uint64_t)counters->failures;
+
+    stats->pooled_blocks = 0;
+    for (int size_class = 0; size_class < POOL_CLASSES; size_class++) {
+        pool_depot_lock(&pool_depots[size_class]);
+        stats->pooled_blocks += pool_depots[size_class].count;
+        pool_depot_unlock(&pool_depots[size_class]);
+    }
+}
+
+/* Return every block parked in the shared depots to the system */
+static void pool_release_depots(void) {
+    for (int size_class = 0; size_class < POOL_CLASSES; size_class++) {
+        pool_depot_t* depot = &pool_depots[size_class];
+        pool_depot_lock(depot);
+        pool_block_t* block = depot->head;
+        depot->head = NULL;
+        depot->count = 0;
+        pool_depot_unlock(depot);
+
+        while (block != NULL) {
+            pool_block_t* next = block->next;
+            free((char*)block - POOL_HEADER_SIZE);
+            block = next;
+        }
+    }
+}
+
 /* Platform-specific initialization */
 int rholang_native_init(void) {
     printf("RhoLang native platform initialized\n");
@@ -16,68 +388,607 @@ int rholang_native_init(void) {
 
 /* Platform-specific cleanup */
 void rholang_native_cleanup(void) {
+    pool_flush_thread_cache(&pool_cache);
+    pool_release_depots();
     printf("RhoLang native platform cleaned up\n");
 }
 
-/* Memory allocation wrapper */
-void* rholang_native_alloc(size_t size) {
-    void* ptr = malloc(size);
-    if (!ptr) {
-        fprintf(stderr, "Native allocation failed for size %zu\n", size);
+/* System call wrapper for getting environment variables */
+const char* rholang_native_getenv(const char* name) {
+    return getenv(name);
+}
+
+#define NATIVE_NAME_MAX 256
+
+/*
+ * NUL-terminated copy of a (ptr, len) string in buffer, or on the heap when
+ * it does not fit; release it with native_unterminate. NULL when out of
+ * memory.
+ */
+static char* native_terminate(const char* str, size_t len, char* buffer, size_t size) {
+    char* out = buffer;
+    if (len >= size) {
+        if (len == SIZE_MAX || !(out = (char*)malloc(len + 1))) {
+            return NULL;
+        }
+    }
+    memcpy(out, str, len);
+    out[len] = '\0';
+    return out;
+}
+
+static void native_unterminate(char* str, const char* buffer) {
+    if (str != buffer) {
+        free(str);
+    }
+}
+
+const char* rholang_native_getenv_n(const char* name, size_t len) {
+    char buffer[NATIVE_NAME_MAX];
+    if (!name) {
         return NULL;
     }
-    memset(ptr, 0, size);
-    return ptr;
+    char* terminated = native_terminate(name, len, buffer, sizeof(buffer));
+    if (!terminated) {
+        return NULL;
+    }
+    const char* value = getenv(terminated);
+    native_unterminate(terminated, buffer);
+    return value;
 }
 
-/* Memory deallocation wrapper */
-void rholang_native_free(void* ptr) {
-    if (ptr) {
-        free(ptr);
+/*
+ * File existence
+ *
+ * access(F_OK) answers without opening the file. The optional cache maps
+ * recently probed paths (hits and misses alike) to their answer, which is
+ * what a module resolver walking its search path asks over and over. It is
+ * direct-mapped by path hash, so a colliding path simply evicts the old one.
+ */
+
+#define FILE_CACHE_SLOTS 1024
+#define NATIVE_PATH_MAX  4096
+
+typedef struct {
+    uint64_t hash;
+    char* path;
+    size_t len;
+    int exists;
+} file_cache_entry_t;
+
+static atomic_int file_cache_enabled;
+static atomic_int file_cache_lock;
+static file_cache_entry_t file_cache[FILE_CACHE_SLOTS];
+
+/* Held only for a slot compare or swap */
+static void file_cache_acquire(void) {
+    native_spin_lock(&file_cache_lock);
+}
+
+static void file_cache_release(void) {
+    native_spin_unlock(&file_cache_lock);
+}
+
+/* FNV-1a */
+static uint64_t path_hash(const char* path, size_t len) {
+    uint64_t hash = UINT64_C(0xCBF29CE484222325);
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)path[i];
+        hash *= UINT64_C(0x100000001B3);
     }
+    return hash;
 }
 
-/* System call wrapper for getting environment variables */
-const char* rholang_native_getenv(const char* name) {
-    return getenv(name);
+static int path_exists(const char* path) {
+    return access(path, F_OK) == 0;
+}
+
+static int file_cache_lookup(uint64_t hash, const char* path, size_t len, int* exists) {
+    file_cache_entry_t* entry = &file_cache[hash % FILE_CACHE_SLOTS];
+    int found = 0;
+    file_cache_acquire();
+    if (entry->path && entry->hash == hash && entry->len == len && memcmp(entry->path, path, len) == 0) {
+        *exists = entry->exists;
+        found = 1;
+    }
+    file_cache_release();
+    return found;
+}
+
+static void file_cache_store(uint64_t hash, const char* path, size_t len, int exists) {
+    char* copy = (char*)malloc(len);
+    if (!copy) {
+        return;
+    }
+    memcpy(copy, path, len);
+
+    file_cache_entry_t* entry = &file_cache[hash % FILE_CACHE_SLOTS];
+    file_cache_acquire();
+    char* evicted = entry->path;
+    entry->hash = hash;
+    entry->path = copy;
+    entry->len = len;
+    entry->exists = exists;
+    file_cache_release();
+    free(evicted);
+}
+
+void rholang_native_file_cache_enable(int enabled) {
+    atomic_store(&file_cache_enabled, enabled != 0);
+    if (!enabled) {
+        rholang_native_file_cache_clear();
+    }
+}
+
+void rholang_native_file_cache_clear(void) {
+    for (size_t i = 0; i < FILE_CACHE_SLOTS; i++) {
+        file_cache_acquire();
+        char* evicted = file_cache[i].path;
+        file_cache[i].path = NULL;
+        file_cache[i].len = 0;
+        file_cache_release();
+        free(evicted);
+    }
+}
+
+int rholang_native_file_exists_n(const char* path, size_t len) {
+    if (!path || len == 0) {
+        return 0;
+    }
+
+    int cached = atomic_load_explicit(&file_cache_enabled, memory_order_relaxed);
+    uint64_t hash = 0;
+    int exists;
+    if (cached) {
+        hash = path_hash(path, len);
+        if (file_cache_lookup(hash, path, len, &exists)) {
+            return exists;
+        }
+    }
+
+    char buffer[NATIVE_PATH_MAX];
+    char* terminated = native_terminate(path, len, buffer, sizeof(buffer));
+    if (!terminated) {
+        return 0;
+    }
+    exists = path_exists(terminated);
+    native_unterminate(terminated, buffer);
+
+    if (cached) {
+        file_cache_store(hash, path, len, exists);
+    }
+    return exists;
 }
 
 /* Platform-specific file operations */
 int rholang_native_file_exists(const char* path) {
-    FILE* f = fopen(path, "r");
-    if (f) {
-        fclose(f);
-        return 1;
+    if (!path) {
+        return 0;
     }
-    return 0;
+    if (atomic_load_explicit(&file_cache_enabled, memory_order_relaxed)) {
+        return rholang_native_file_exists_n(path, strlen(path));
+    }
+    return path_exists(path);
+}
+
+/*
+ * Callbacks
+ *
+ * Values reach the legacy single-value callback and every batch subscriber.
+ * Unbuffered, each trigger call delivers straight away on the caller's
+ * thread. Buffered, values are queued in a bounded lock-free MPSC ring and
+ * delivered in batches whenever flush_count are pending, when the interval
+ * timer fires, or on an explicit flush. Buffered deliveries are serialized,
+ * so subscribers see values in queue order and never run concurrently.
+ */
+
+#define CALLBACK_MAX_SUBSCRIBERS 8
+#define CALLBACK_CHUNK           256    /* values per delivery while draining */
+#define CALLBACK_MIN_CAPACITY    64
+
+typedef struct {
+    rholang_batch_callback_t callback;
+    void* ctx;
+} callback_subscriber_t;
+
+static _Atomic(rholang_callback_t) user_callback = NULL;
+
+/* Subscriber table; deliveries copy it under the lock and call outside it */
+static atomic_int subscribers_lock;
+static callback_subscriber_t subscribers[CALLBACK_MAX_SUBSCRIBERS];
+
+/* Held only to copy or edit the table */
+static void subscribers_acquire(void) {
+    native_spin_lock(&subscribers_lock);
+}
+
+static void subscribers_release(void) {
+    native_spin_unlock(&subscribers_lock);
 }
 
-/* Callback function that Rust can provide */
-static rholang_callback_t user_callback = NULL;
+static void callback_deliver(const int* values, size_t count) {
+    callback_subscriber_t active[CALLBACK_MAX_SUBSCRIBERS];
+    size_t active_count = 0;
+
+    subscribers_acquire();
+    for (size_t i = 0; i < CALLBACK_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].callback != NULL) {
+            active[active_count++] = subscribers[i];
+        }
+    }
+    subscribers_release();
+
+    for (size_t i = 0; i < active_count; i++) {
+        active[i].callback(values, count, active[i].ctx);
+    }
+
+    rholang_callback_t single = atomic_load_explicit(&user_callback, memory_order_acquire);
+    if (single) {
+        for (size_t i = 0; i < count; i++) {
+            single(values[i]);
+        }
+    } else if (active_count == 0) {
+        printf("No callback set\n");
+    }
+}
 
 void rholang_native_set_callback(rholang_callback_t callback) {
-    user_callback = callback;
+    atomic_store_explicit(&user_callback, callback, memory_order_release);
+}
+
+int rholang_native_subscribe(rholang_batch_callback_t callback, void* ctx) {
+    if (!callback) {
+        return -1;
+    }
+    int id = -1;
+    subscribers_acquire();
+    for (int i = 0; i < CALLBACK_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].callback == NULL) {
+            subscribers[i].callback = callback;
+            subscribers[i].ctx = ctx;
+            id = i;
+            break;
+        }
+    }
+    subscribers_release();
+    return id;
+}
+
+void rholang_native_unsubscribe(int subscription) {
+    if (subscription < 0 || subscription >= CALLBACK_MAX_SUBSCRIBERS) {
+        return;
+    }
+    subscribers_acquire();
+    subscribers[subscription].callback = NULL;
+    subscribers[subscription].ctx = NULL;
+    subscribers_release();
+}
+
+#ifndef _WIN32
+typedef struct {
+    atomic_size_t sequence;
+    int value;
+} callback_slot_t;
+
+/*
+ * Start/stop lifecycle, claimed with a compare-and-swap so that only one
+ * caller sets up or tears down the ring. buffering is the hot-path flag
+ * producers check; it is only set while the state is BUFFER_RUNNING.
+ */
+enum {
+    BUFFER_IDLE,
+    BUFFER_STARTING,
+    BUFFER_RUNNING,
+    BUFFER_STOPPING
+};
+
+static atomic_int buffer_state;
+static atomic_int buffering;
+static atomic_int buffered_producers;
+static callback_slot_t* event_ring;
+static size_t event_mask;
+static size_t event_flush_count;
+static atomic_size_t event_enqueue;
+static atomic_size_t event_dequeue;
+
+/* Held by whoever drains the ring */
+static pthread_mutex_t flush_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Set while this thread drains the ring, i.e. runs subscribers with
+ * flush_lock held. Calls they make back into buffering must not take the
+ * lock again: flushes are left to the drain in progress, which runs until
+ * the ring is empty, and stops are ignored.
+ */
+static _Thread_local int event_draining;
+
+/* Interval flusher */
+static pthread_mutex_t flusher_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t flusher_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t flusher_thread;
+static int flusher_running;
+static int flusher_stop;
+static unsigned flusher_interval_ms;
+
+static int event_enqueue_value(int value) {
+    size_t pos = atomic_load_explicit(&event_enqueue, memory_order_relaxed);
+    for (;;) {
+        callback_slot_t* slot = &event_ring[pos & event_mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&event_enqueue, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                slot->value = value;
+                atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+                return 0;
+            }
+        } else if (diff < 0) {
+            return -1; /* full */
+        } else {
+            pos = atomic_load_explicit(&event_enqueue, memory_order_relaxed);
+        }
+    }
+}
+
+/* Caller holds flush_lock */
+static void event_drain_locked(void) {
+    int chunk[CALLBACK_CHUNK];
+    size_t count = 0;
+    size_t pos = atomic_load_explicit(&event_dequeue, memory_order_relaxed);
+
+    event_draining = 1;
+    for (;;) {
+        callback_slot_t* slot = &event_ring[pos & event_mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        if (sequence != pos + 1) {
+            if (count == 0) {
+                break;
+            }
+            /* Deliver the tail, then look again: subscribers may have
+             * queued more while it ran */
+            callback_deliver(chunk, count);
+            count = 0;
+            continue;
+        }
+        chunk[count++] = slot->value;
+        atomic_store_explicit(&slot->sequence, pos + event_mask + 1, memory_order_release);
+        pos++;
+        atomic_store_explicit(&event_dequeue, pos, memory_order_relaxed);
+
+        if (count == CALLBACK_CHUNK) {
+            callback_deliver(chunk, count);
+            count = 0;
+        }
+    }
+    event_draining = 0;
+}
+
+static void event_push(int value) {
+    while (event_enqueue_value(value) != 0) {
+        if (event_draining) {
+            /* Full while a subscriber triggers: it cannot wait for its own
+             * drain, so this value skips the queue */
+            callback_deliver(&value, 1);
+            return;
+        }
+        /* Ring full: drain it ourselves rather than drop the value */
+        pthread_mutex_lock(&flush_lock);
+        event_drain_locked();
+        pthread_mutex_unlock(&flush_lock);
+    }
+}
+
+static void event_maybe_flush(void) {
+    size_t pending = atomic_load_explicit(&event_enqueue, memory_order_relaxed) -
+                     atomic_load_explicit(&event_dequeue, memory_order_relaxed);
+    if (pending >= event_flush_count && !event_draining && pthread_mutex_trylock(&flush_lock) == 0) {
+        event_drain_locked();
+        pthread_mutex_unlock(&flush_lock);
+    }
+}
+
+/* Queue values if buffering is on; returns 0 if the caller must deliver */
+static int event_buffer(const int* values, size_t count) {
+    atomic_fetch_add(&buffered_producers, 1);
+    int buffered = atomic_load(&buffering);
+    if (buffered) {
+        for (size_t i = 0; i < count; i++) {
+            event_push(values[i]);
+        }
+        event_maybe_flush();
+    }
+    atomic_fetch_sub(&buffered_producers, 1);
+    return buffered;
+}
+
+static void* flusher_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&flusher_lock);
+    while (!flusher_stop) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += flusher_interval_ms / 1000;
+        deadline.tv_nsec += (long)(flusher_interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&flusher_wake, &flusher_lock, &deadline);
+        if (flusher_stop) {
+            break;
+        }
+
+        pthread_mutex_unlock(&flusher_lock);
+        pthread_mutex_lock(&flush_lock);
+        event_drain_locked();
+        pthread_mutex_unlock(&flush_lock);
+        pthread_mutex_lock(&flusher_lock);
+    }
+    pthread_mutex_unlock(&flusher_lock);
+    return NULL;
+}
+
+int rholang_native_buffer_start(size_t capacity, size_t flush_count, unsigned flush_interval_ms) {
+    int expected = BUFFER_IDLE;
+    if (!atomic_compare_exchange_strong(&buffer_state, &expected, BUFFER_STARTING)) {
+        return -1;
+    }
+
+    size_t size = CALLBACK_MIN_CAPACITY;
+    while (size < capacity) {
+        if (size > SIZE_MAX / 2 / sizeof(callback_slot_t)) {
+            atomic_store(&buffer_state, BUFFER_IDLE);
+            return -2;
+        }
+        size <<= 1;
+    }
+    callback_slot_t* ring = (callback_slot_t*)malloc(size * sizeof(callback_slot_t));
+    if (!ring) {
+        atomic_store(&buffer_state, BUFFER_IDLE);
+        return -2;
+    }
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&ring[i].sequence, i);
+    }
+
+    event_ring = ring;
+    event_mask = size - 1;
+    event_flush_count = (flush_count == 0 || flush_count > size) ? size / 2 : flush_count;
+    atomic_store(&event_enqueue, 0);
+    atomic_store(&event_dequeue, 0);
+
+    flusher_stop = 0;
+    flusher_running = 0;
+    flusher_interval_ms = flush_interval_ms;
+    if (flush_interval_ms > 0) {
+        if (pthread_create(&flusher_thread, NULL, flusher_main, NULL) != 0) {
+            free(ring);
+            event_ring = NULL;
+            atomic_store(&buffer_state, BUFFER_IDLE);
+            return -1;
+        }
+        flusher_running = 1;
+    }
+
+    atomic_store(&buffering, 1);
+    atomic_store(&buffer_state, BUFFER_RUNNING);
+    return 0;
 }
 
+void rholang_native_buffer_flush(void) {
+    if (!atomic_load(&buffering) || event_draining) {
+        return;
+    }
+    atomic_fetch_add(&buffered_producers, 1);
+    if (atomic_load(&buffering)) {
+        pthread_mutex_lock(&flush_lock);
+        event_drain_locked();
+        pthread_mutex_unlock(&flush_lock);
+    }
+    atomic_fetch_sub(&buffered_producers, 1);
+}
+
+void rholang_native_buffer_stop(void) {
+    /* From a subscriber: the ring and flusher are still in use */
+    if (event_draining) {
+        return;
+    }
+    int expected = BUFFER_RUNNING;
+    if (!atomic_compare_exchange_strong(&buffer_state, &expected, BUFFER_STOPPING)) {
+        return;
+    }
+    atomic_store(&buffering, 0);
+    /* New triggers now deliver directly; let in-flight ones finish queueing */
+    while (atomic_load(&buffered_producers) != 0) {
+        sched_yield();
+    }
+
+    if (flusher_running) {
+        pthread_mutex_lock(&flusher_lock);
+        flusher_stop = 1;
+        pthread_cond_signal(&flusher_wake);
+        pthread_mutex_unlock(&flusher_lock);
+        pthread_join(flusher_thread, NULL);
+        flusher_running = 0;
+    }
+
+    pthread_mutex_lock(&flush_lock);
+    event_drain_locked();
+    pthread_mutex_unlock(&flush_lock);
+
+    free(event_ring);
+    event_ring = NULL;
+    atomic_store(&buffer_state, BUFFER_IDLE);
+}
+#else
+/* No buffered mode without pthreads: triggers always deliver directly */
+static int event_buffer(const int* values, size_t count) {
+    (void)values;
+    (void)count;
+    return 0;
+}
+
+int rholang_native_buffer_start(size_t capacity, size_t flush_count, unsigned flush_interval_ms) {
+    (void)capacity;
+    (void)flush_count;
+    (void)flush_interval_ms;
+    return -1;
+}
+
+void rholang_native_buffer_flush(void) {
+}
+
+void rholang_native_buffer_stop(void) {
+}
+#endif
+
 void rholang_native_trigger_callback(int value) {
-    if (user_callback) {
-        user_callback(value);
-    } else {
-        printf("No callback set\n");
+    if (!event_buffer(&value, 1)) {
+        callback_deliver(&value, 1);
+    }
+}
+
+void rholang_native_trigger_batch(const int* values, size_t count) {
+    if (!values || count == 0) {
+        return;
+    }
+    if (!event_buffer(values, count)) {
+        callback_deliver(values, count);
     }
 }
 
 /* String manipulation helper */
 char* rholang_native_string_copy(const char* str) {
     if (!str) return NULL;
-    size_t len = strlen(str);
-    char* copy = (char*)malloc(len + 1);
+    return rholang_native_string_copy_n(str, strlen(str));
+}
+
+char* rholang_native_string_copy_n(const char* str, size_t len) {
+    if (!str || len == SIZE_MAX) return NULL;
+    char* copy = (char*)rholang_native_alloc_uninit(len + 1);
     if (copy) {
-        strcpy(copy, str);
+        memcpy(copy, str, len);
+        copy[len] = '\0';
     }
     return copy;
 }
 
+size_t rholang_native_string_copy_into(const char* str, size_t len, char* out, size_t out_size) {
+    if (!str) {
+        len = 0;
+    }
+    if (len < out_size) {
+        if (len > 0) {
+            memcpy(out, str, len);
+        }
+        out[len] = '\0';
+    } else if (out_size > 0) {
+        out[0] = '\0';
+    }
+    return len;
+}
+
 /* Error code utilities */
 const char* rholang_native_error_string(int error_code) {
     switch (error_code) {
@@ -0,0 +1,461 @@
+// Compile-once execution sessions for C embedders
+//
+// A session owns a warmed VM plus every program it has compiled. Sources
+// are compiled once and cached by text, so running the same script again
+// (through rholang_execute_code or a batch) skips the whole front end and
+// only pays for the VM run. Each uncached compile gets a fresh front end:
+// the analyzers keep scopes and errors, which must not leak from one
+// source into the next.
+//
+// A session's cache is unbounded unless it was given a limit; a full cache
+// is flushed before the next compile, and ids from before the flush become
+// unknown rather than naming other programs.
+
+use crate::RholangStr;
+use codegen_bytecode::instruction::Value;
+use codegen_bytecode::BytecodeGenerator;
+use ir_gen::IrGenerator;
+use lexer::Lexer;
+use parser::Parser;
+use semantic_analyzer::SemanticAnalyzer;
+use std::collections::HashMap;
+use std::ffi::CString;
+use std::os::raw::{c_char, c_int};
+use std::sync::Mutex;
+use type_checker::TypeChecker;
+use vm_runtime::Runtime;
+
+pub struct Session {
+    runtime: Runtime,
+    programs: Vec<Vec<u8>>,
+    by_source: HashMap<String, u32>,
+    first_id: u32,
+    cache_limit: Option<usize>,
+    loaded: u32,
+    last_error: CString,
+}
+
+impl Session {
+    pub fn new() -> Self {
+        Self {
+            runtime: Runtime::new(),
+            programs: Vec::new(),
+            by_source: HashMap::new(),
+            first_id: 1,
+            cache_limit: None,
+            loaded: 0,
+            last_error: CString::default(),
+        }
+    }
+
+    /// A session that keeps at most `limit` compiled programs
+    pub fn with_cache_limit(limit: usize) -> Self {
+        Self {
+            cache_limit: Some(limit),
+            ..Self::new()
+        }
+    }
+
+    /// Compile `source` to bytecode, or return the id it already has.
+    /// Program ids start at 1.
+    pub fn compile(&mut self, source: &str) -> Result<u32, String> {
+        if let Some(&id) = self.by_source.get(source) {
+            return Ok(id);
+        }
+
+        let bytecode = Self::compile_uncached(source)?;
+        if self.cache_limit.is_some_and(|limit| self.programs.len() >= limit) {
+            self.first_id += self.programs.len() as u32;
+            self.programs.clear();
+            self.by_source.clear();
+            self.loaded = 0;
+        }
+        self.programs.push(bytecode);
+        let id = self.first_id + self.programs.len() as u32 - 1;
+        self.by_source.insert(source.to_string(), id);
+        Ok(id)
+    }
+
+    // Same front end as rholang-cli's Compiler, continued down to bytecode
+    fn compile_uncached(source: &str) -> Result<Vec<u8>, String> {
+        let mut lexer = Lexer::new(source);
+        let tokens = lexer.tokenize().map_err(|_| "Lexer error".to_string())?;
+
+        let mut parser = Parser::new(tokens);
+        let declarations = parser.parse().map_err(|_| "Parser error".to_string())?;
+
+        let ast = ast::Ast::new(
+            declarations
+                .into_iter()
+                .map(|d| ast::AstNode::new(0, ast::nodes::NodeKind::Program { declarations: vec![] }, d.span))
+                .collect(),
+        );
+
+        SemanticAnalyzer::new()
+            .analyze(&ast)
+            .map_err(|_| "Semantic analysis error".to_string())?;
+
+        TypeChecker::new()
+            .check(&ast)
+            .map_err(|_| "Type checking error".to_string())?;
+
+        let module = IrGenerator::new().generate(&ast)?;
+        Ok(BytecodeGenerator::new().generate(&module))
+    }
+
+    /// Run a compiled program with `inputs` bound to its entry function's
+    /// parameters. The VM only reloads when the program changes.
+    pub fn run(&mut self, program: u32, inputs: &[i64]) -> Result<i64, String> {
+        if program != self.loaded {
+            let bytecode = program
+                .checked_sub(self.first_id)
+                .and_then(|idx| self.programs.get(idx as usize))
+                .ok_or_else(|| format!("Unknown program {}", program))?;
+            self.runtime.load(bytecode);
+            self.loaded = program;
+        }
+
+        match self.runtime.run_loaded(inputs.iter().map(|&i| Value::Int(i))) {
+            Ok(Some(Value::Int(i))) => Ok(i),
+            Ok(_) => Ok(0),
+            Err(e) => Err(format!("VM error: {:?}", e)),
+        }
+    }
+
+    /// Compile (or look up) and run `source` with no inputs
+    pub fn execute(&mut self, source: &str) -> Result<i64, String> {
+        let program = self.compile(source)?;
+        self.run(program, &[])
+    }
+
+    pub fn program_count(&self) -> usize {
+        self.programs.len()
+    }
+
+    fn fail(&mut self, message: String) {
+        self.last_error = CString::new(message).unwrap_or_default();
+    }
+}
+
+impl Default for Session {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+unsafe fn source_str<'a>(source: *const c_char, len: usize) -> Result<&'a str, String> {
+    if source.is_null() {
+        return Err("Null source".to_string());
+    }
+    let bytes = std::slice::from_raw_parts(source as *const u8, len);
+    std::str::from_utf8(bytes).map_err(|_| "Source is not valid UTF-8".to_string())
+}
+
+// Session behind rholang_execute_code, created by rholang_runtime_init or
+// on first use and dropped by rholang_runtime_shutdown. Any C caller can
+// feed it sources, so its cache is bounded.
+static DEFAULT_SESSION: Mutex<Option<Session>> = Mutex::new(None);
+
+pub(crate) const DEFAULT_CACHE_LIMIT: usize = 256;
+
+pub(crate) fn with_default_session<R>(f: impl FnOnce(&mut Session) -> R) -> R {
+    let mut guard = DEFAULT_SESSION.lock().unwrap_or_else(|e| e.into_inner());
+    f(guard.get_or_insert_with(|| Session::with_cache_limit(DEFAULT_CACHE_LIMIT)))
+}
+
+pub(crate) fn drop_default_session() {
+    let mut guard = DEFAULT_SESSION.lock().unwrap_or_else(|e| e.into_inner());
+    *guard = None;
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_session_create() -> *mut Session {
+    Box::into_raw(Box::new(Session::new()))
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_session_destroy(session: *mut Session) {
+    if !session.is_null() {
+        unsafe {
+            let _ = Box::from_raw(session);
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_session_compile(
+    session: *mut Session,
+    source: *const c_char,
+    len: usize,
+) -> u32 {
+    if session.is_null() {
+        return 0;
+    }
+
+    unsafe {
+        let session = &mut *session;
+        match source_str(source, len).and_then(|s| session.compile(s)) {
+            Ok(id) => id,
+            Err(e) => {
+                session.fail(e);
+                0
+            }
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_session_run(
+    session: *mut Session,
+    program: u32,
+    inputs: *const i64,
+    input_count: usize,
+    result: *mut i64,
+) -> c_int {
+    if session.is_null() || (inputs.is_null() && input_count > 0) {
+        return -1;
+    }
+
+    unsafe {
+        let session = &mut *session;
+        let inputs = if input_count > 0 {
+            std::slice::from_raw_parts(inputs, input_count)
+        } else {
+            &[]
+        };
+
+        match session.run(program, inputs) {
+            Ok(value) => {
+                if !result.is_null() {
+                    *result = value;
+                }
+                0
+            }
+            Err(e) => {
+                session.fail(e);
+                -1
+            }
+        }
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_session_run_many(
+    session: *mut Session,
+    program: u32,
+    inputs: *const i64,
+    inputs_per_run: usize,
+    runs: usize,
+    results: *mut i64,
+) -> usize {
+    if session.is_null() || results.is_null() || (inputs.is_null() && inputs_per_run > 0) {
+        return 0;
+    }
+
+    unsafe {
+        let session = &mut *session;
+        let inputs = if inputs_per_run > 0 {
+            match inputs_per_run.checked_mul(runs) {
+                Some(total) => std::slice::from_raw_parts(inputs, total),
+                None => return 0,
+            }
+        } else {
+            &[]
+        };
+        let results = std::slice::from_raw_parts_mut(results, runs);
+
+        for (run, slot) in results.iter_mut().enumerate() {
+            let row = if inputs_per_run > 0 {
+                &inputs[run * inputs_per_run..(run + 1) * inputs_per_run]
+            } else {
+                &[]
+            };
+            match session.run(program, row) {
+                Ok(value) => *slot = value,
+                Err(e) => {
+                    session.fail(e);
+                    return run;
+                }
+            }
+        }
+        runs
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_session_execute_batch(
+    session: *mut Session,
+    sources: *const RholangStr,
+    count: usize,
+    results: *mut i64,
+    statuses: *mut c_int,
+) -> usize {
+    if session.is_null() || (sources.is_null() && count > 0) {
+        return 0;
+    }
+
+    unsafe {
+        let session = &mut *session;
+        let sources = if count > 0 {
+            std::slice::from_raw_parts(sources, count)
+        } else {
+            &[]
+        };
+
+        let mut succeeded = 0;
+        for (i, src) in sources.iter().enumerate() {
+            let outcome = source_str(src.ptr, src.len).and_then(|s| session.execute(s));
+            let (value, status) = match outcome {
+                Ok(value) => {
+                    succeeded += 1;
+                    (value, 0)
+                }
+                Err(e) => {
+                    session.fail(e);
+                    (0, -1)
+                }
+            };
+            if !results.is_null() {
+                *results.add(i) = value;
+            }
+            if !statuses.is_null() {
+                *statuses.add(i) = status;
+            }
+        }
+        succeeded
+    }
+}
+
+#[no_mangle]
+pub extern "C" fn rholang_session_last_error(session: *const Session) -> *const c_char {
+    if session.is_null() {
+        return std::ptr::null();
+    }
+    unsafe { (*session).last_error.as_ptr() }
+}
+
+pub(crate) unsafe fn execute_code(source: *const c_char, len: usize) -> c_int {
+    let source = match source_str(source, len) {
+        Ok(s) => s,
+        Err(_) => return -1,
+    };
+
+    with_default_session(|session| match session.execute(source) {
+        Ok(_) => 0,
+        Err(e) => {
+            session.fail(e);
+            -1
+        }
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_session_compile_caches() {
+        let mut session = Session::new();
+        let first = session.compile("").unwrap();
+        let second = session.compile("").unwrap();
+        assert_eq!(first, second);
+        assert_eq!(session.program_count(), 1);
+        assert_eq!(session.run(first, &[]), Ok(0));
+        assert!(session.run(first + 1, &[]).is_err());
+    }
+
+    #[test]
+    fn test_session_binds_function_inputs() {
+        let mut session = Session::new();
+        let source = "fn add(a: Int, b: Int) -> Int { return a + b; }";
+        let program = session.compile(source).unwrap();
+        assert_eq!(session.compile(source), Ok(program));
+        assert!(session.run(program, &[2, 3]).is_ok());
+        assert!(session.run(program, &[40, 2]).is_ok());
+    }
+
+    #[test]
+    fn test_session_cache_limit() {
+        let mut session = Session::with_cache_limit(2);
+        let a = session.compile("fn a() -> Int { return 1; }").unwrap();
+        let b = session.compile("fn b() -> Int { return 2; }").unwrap();
+        assert_eq!(session.program_count(), 2);
+
+        // Full: flushed, and the old ids no longer resolve
+        let c = session.compile("fn c() -> Int { return 3; }").unwrap();
+        assert_eq!(session.program_count(), 1);
+        assert!(c > b);
+        assert!(session.run(a, &[]).is_err());
+        assert!(session.run(b, &[]).is_err());
+        assert!(session.run(c, &[]).is_ok());
+
+        let again = session.compile("fn a() -> Int { return 1; }").unwrap();
+        assert_ne!(again, a);
+        assert_eq!(session.program_count(), 2);
+    }
+
+    #[test]
+    fn test_default_session_bounded() {
+        for i in 0..DEFAULT_CACHE_LIMIT + 10 {
+            let source = format!("fn f{}() -> Int {{ return {}; }}", i, i);
+            assert_eq!(unsafe { execute_code(source.as_ptr() as *const c_char, source.len()) }, 0);
+        }
+        assert!(with_default_session(|session| session.program_count()) <= DEFAULT_CACHE_LIMIT);
+    }
+
+    #[test]
+    fn test_session_recovers_from_failed_compile() {
+        let session = rholang_session_create();
+        let invalid = [0xffu8, b'(', b')'];
+        assert_eq!(rholang_session_compile(session, invalid.as_ptr() as *const c_char, invalid.len()), 0);
+
+        let source = "fn id(x: Int) -> Int { return x; }";
+        let program = rholang_session_compile(session, source.as_ptr() as *const c_char, source.len());
+        assert_ne!(program, 0);
+        let input = 7i64;
+        let mut result = -1i64;
+        assert_eq!(rholang_session_run(session, program, &input, 1, &mut result), 0);
+        assert_eq!(unsafe { (*session).program_count() }, 1);
+
+        rholang_session_destroy(session);
+    }
+
+    #[test]
+    fn test_session_c_interface() {
+        let session = rholang_session_create();
+        assert!(!session.is_null());
+
+        let program = rholang_session_compile(session, "".as_ptr() as *const c_char, 0);
+        assert_ne!(program, 0);
+
+        let mut result = -1i64;
+        assert_eq!(rholang_session_run(session, program, std::ptr::null(), 0, &mut result), 0);
+        assert_eq!(result, 0);
+
+        let mut results = [-1i64; 4];
+        let ran = rholang_session_run_many(session, program, std::ptr::null(), 0, 4, results.as_mut_ptr());
+        assert_eq!(ran, 4);
+
+        let invalid = [0xffu8];
+        let sources = [
+            RholangStr::from_str(""),
+            RholangStr {
+                ptr: invalid.as_ptr() as *const c_char,
+                len: invalid.len(),
+            },
+        ];
+        let mut statuses = [1 as c_int; 2];
+        let ok = rholang_session_execute_batch(
+            session,
+            sources.as_ptr(),
+            sources.len(),
+            results.as_mut_ptr(),
+            statuses.as_mut_ptr(),
+        );
+        assert_eq!(ok, 1);
+        assert_eq!(statuses, [0, -1]);
+        assert!(!rholang_session_last_error(session).is_null());
+
+        rholang_session_destroy(session);
+    }
+}
@@ -3,6 +3,17 @@ use std::collections::HashMap;
 #[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
 pub struct InternedString(usize);
 
+impl InternedString {
+    /// Position in the interner's table, for handing ids across FFI
+    pub fn as_index(self) -> usize {
+        self.0
+    }
+
+    pub fn from_index(index: usize) -> Self {
+        Self(index)
+    }
+}
+
 pub struct SpanInterner {
     strings: Vec<String>,
     indices: HashMap<String, InternedString>,
@@ -68,4 +79,14 @@ mod tests {
         assert_eq!(interner.resolve(id1), Some("foo"));
         assert_eq!(interner.resolve(id2), Some("bar"));
     }
+
+    #[test]
+    fn test_interner_index_roundtrip() {
+        let mut interner = SpanInterner::new();
+        interner.intern("foo");
+        let id = interner.intern("bar");
+        assert_eq!(id.as_index(), 1);
+        assert_eq!(interner.resolve(InternedString::from_index(1)), Some("bar"));
+        assert_eq!(interner.resolve(InternedString::from_index(2)), None);
+    }
 }
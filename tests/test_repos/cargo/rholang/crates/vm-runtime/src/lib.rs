@@ -21,6 +21,24 @@ impl Runtime {
         self.vm.load(bytecode);
         self.vm.run()
     }
+
+    /// Load a program once for any number of `run_loaded` calls
+    pub fn load(&mut self, bytecode: &[u8]) {
+        self.vm.load(bytecode);
+    }
+
+    /// Re-run the loaded program from the top, with `inputs` bound to
+    /// locals 0..n (the entry function's parameters)
+    pub fn run_loaded<I>(&mut self, inputs: I) -> Result<Option<Value>, VMError>
+    where
+        I: IntoIterator<Item = Value>,
+    {
+        self.vm.reset();
+        for (idx, value) in inputs.into_iter().enumerate() {
+            self.vm.set_local(idx, value)?;
+        }
+        self.vm.run()
+    }
 }
 
 impl Default for Runtime {
@@ -40,4 +58,16 @@ mod tests {
         let result = runtime.execute(&bytecode);
         assert!(result.is_ok());
     }
+
+    #[test]
+    fn test_runtime_run_loaded() {
+        let mut runtime = Runtime::new();
+        runtime.load(&[0x11, 0x00, 0x00, 0xFF]); // LoadLocal 0; Halt
+        for input in 0..3 {
+            match runtime.run_loaded([Value::Int(input)]) {
+                Ok(Some(Value::Int(i))) => assert_eq!(i, input),
+                other => panic!("unexpected result: {:?}", other),
+            }
+        }
+    }
 }
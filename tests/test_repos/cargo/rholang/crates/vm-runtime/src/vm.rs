@@ -31,8 +31,23 @@ impl VM {
     }
 
     pub fn load(&mut self, bytecode: &[u8]) {
-        self.bytecode = bytecode.to_vec();
+        self.bytecode.clear();
+        self.bytecode.extend_from_slice(bytecode);
+        self.reset();
+    }
+
+    /// Rewind to the start of the loaded program with an empty stack and
+    /// cleared locals, keeping every buffer's capacity for the next run
+    pub fn reset(&mut self) {
         self.pc = 0;
+        self.stack.clear();
+        self.locals.fill(Value::Unit);
+    }
+
+    pub fn set_local(&mut self, idx: usize, value: Value) -> Result<(), VMError> {
+        let slot = self.locals.get_mut(idx).ok_or(VMError::OutOfBounds)?;
+        *slot = value;
+        Ok(())
     }
 
     pub fn run(&mut self) -> Result<Option<Value>, VMError> {
@@ -261,4 +276,24 @@ mod tests {
         let result = vm.run();
         assert!(result.is_ok());
     }
+
+    #[test]
+    fn test_vm_reset_between_runs() {
+        let mut vm = VM::new();
+        // LoadLocal 0; LoadConst 1; Add; Halt
+        let mut bytecode = vec![0x11, 0x00, 0x00, 0x10, 0x01];
+        bytecode.extend_from_slice(&1i64.to_le_bytes());
+        bytecode.extend_from_slice(&[0x20, 0xFF]);
+        vm.load(&bytecode);
+
+        for input in [41, 9] {
+            vm.reset();
+            vm.set_local(0, Value::Int(input)).unwrap();
+            match vm.run() {
+                Ok(Some(Value::Int(i))) => assert_eq!(i, input + 1),
+                other => panic!("unexpected result: {:?}", other),
+            }
+        }
+        assert!(vm.set_local(4096, Value::Int(0)).is_err());
+    }
 }
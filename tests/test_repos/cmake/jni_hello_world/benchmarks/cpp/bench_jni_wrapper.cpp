@@ -0,0 +1,117 @@
+#include "jni_wrapper.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t kCalls = 100000;
+
+	template <typename Fn>
+	double nsPerOp(std::size_t ops, Fn &&fn)
+	{
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::nano>(elapsed).count() / (double)ops;
+	}
+
+	void benchPerCall(JNIWrapper &wrapper, const std::vector<std::string> &names)
+	{
+		std::size_t sink = 0;
+		double ns = nsPerOp(kCalls, [&]()
+							{
+			for (std::size_t i = 0; i < kCalls; ++i)
+			{
+				sink += wrapper.callJavaGreet(names[i % names.size()]).size();
+			} });
+		std::cout << "per-call       " << ns << " ns/op (" << sink << " bytes)" << std::endl;
+	}
+
+	void benchBatched(JNIWrapper &wrapper, const std::vector<std::string> &names, std::size_t batch)
+	{
+		std::vector<std::string> inputs(batch);
+		for (std::size_t i = 0; i < batch; ++i)
+		{
+			inputs[i] = names[i % names.size()];
+		}
+
+		// Size the result buffer once, outside the timed loop
+		std::vector<std::string_view> results(batch);
+		std::vector<char> buffer(wrapper.callJavaGreetBatch(inputs.data(), batch, nullptr, 0, results.data()));
+
+		std::size_t rounds = kCalls / batch;
+		std::size_t sink = 0;
+		double ns = nsPerOp(rounds * batch, [&]()
+							{
+			for (std::size_t round = 0; round < rounds; ++round)
+			{
+				wrapper.callJavaGreetBatch(inputs.data(), batch, buffer.data(), buffer.size(), results.data());
+				sink += results[batch - 1].size();
+			} });
+		std::cout << "batched x" << batch << (batch < 100 ? "   " : "  ")
+				  << ns << " ns/op (" << sink << " bytes)" << std::endl;
+	}
+
+	// Large results: copying into a fresh std::string vs decoding into the
+	// reused per-thread buffer behind callJavaGreetView()
+	void benchLargeStrings(JNIWrapper &wrapper)
+	{
+		for (std::size_t size : {std::size_t(1) << 10, std::size_t(16) << 10,
+								 std::size_t(256) << 10, std::size_t(1) << 20})
+		{
+			std::string name(size, 'x');
+			std::size_t iterations = std::max<std::size_t>(32, (std::size_t(64) << 20) / size);
+
+			std::size_t sink = 0;
+			double copyNs = nsPerOp(iterations, [&]()
+									{
+				for (std::size_t i = 0; i < iterations; ++i)
+				{
+					sink += wrapper.callJavaGreet(name).size();
+				} });
+			double viewNs = nsPerOp(iterations, [&]()
+									{
+				for (std::size_t i = 0; i < iterations; ++i)
+				{
+					sink += wrapper.callJavaGreetView(name).size();
+				} });
+
+			std::cout << (size >> 10) << " KB: string " << copyNs << " ns/op, view "
+					  << viewNs << " ns/op (" << sink << " bytes)" << std::endl;
+		}
+	}
+}
+
+int main()
+{
+	std::cout << "JNI Wrapper Benchmarks" << std::endl;
+
+	try
+	{
+		JNIWrapper wrapper;
+		std::vector<std::string> names = {"Ada", "Grace", "Linus", "Barbara", "Dennis", "Ken"};
+
+		// Warm up the JIT before timing anything
+		for (int i = 0; i < 10000; ++i)
+		{
+			wrapper.callJavaGreet(names[i % names.size()]);
+		}
+
+		benchPerCall(wrapper, names);
+		for (std::size_t batch : {8, 64, 512})
+		{
+			benchBatched(wrapper, names, batch);
+		}
+		benchLargeStrings(wrapper);
+		return 0;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << "❌ Benchmark failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -1,56 +1,194 @@
 #include "jni_wrapper.h"
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
-JNIWrapper::JNIWrapper() : jvm(nullptr), env(nullptr),
-						   helloWorldClass(nullptr), helloWorldJNIClass(nullptr),
-						   helloMethod(nullptr), versionMethod(nullptr)
+namespace
 {
-	initializeJVM();
-	loadJavaClasses();
-	setupMethodIDs();
+	// The VM the wrapper currently owns; attachments made against any other
+	// (already destroyed) VM must not be detached
+	std::atomic<JavaVM *> liveVM{nullptr};
+
+	// Per-thread JNIEnv cache. Threads we attached ourselves are detached in
+	// the destructor when the thread exits; in Eager mode the thread that
+	// created the VM was attached by JNI_CreateJavaVM and is left alone.
+	struct ThreadAttachment
+	{
+		JavaVM *vm = nullptr;
+		JNIEnv *env = nullptr;
+		bool attached = false;
+
+		~ThreadAttachment()
+		{
+			if (attached && liveVM.load(std::memory_order_acquire) == vm)
+			{
+				vm->DetachCurrentThread();
+			}
+		}
+	};
+
+	thread_local ThreadAttachment threadAttachment;
+
+	jclass findGlobalClass(JNIEnv *env, const char *name)
+	{
+		jclass local = env->FindClass(name);
+		if (!local)
+		{
+			env->ExceptionClear();
+			return nullptr;
+		}
+
+		jclass global = (jclass)env->NewGlobalRef(local);
+		env->DeleteLocalRef(local);
+		return global;
+	}
+}
+
+JNIWrapperConfig JNIWrapperConfig::fastStartup()
+{
+	JNIWrapperConfig config;
+	config.sharedArchive = "java_hello_lib.jsa";
+	config.jvmOptions = {"-XX:TieredStopAtLevel=1", "-XX:+UseSerialGC", "-XX:-UsePerfData"};
+	config.startMode = StartMode::Background;
+	return config;
+}
+
+JNIWrapper::JNIWrapper(JNIWrapperConfig config) : config(std::move(config)), jvm(nullptr),
+												  helloWorldClass(nullptr), helloWorldJNIClass(nullptr),
+												  helloMethod(nullptr), versionMethod(nullptr),
+												  greetMethod(nullptr), greetBatchMethod(nullptr)
+{
+	switch (this->config.startMode)
+	{
+	case JNIWrapperConfig::StartMode::Eager:
+		ensureStarted();
+		break;
+	case JNIWrapperConfig::StartMode::Background:
+		starter = std::thread([this]()
+							  {
+			try
+			{
+				ensureStarted();
+			}
+			catch (...)
+			{
+				// Kept in startError and rethrown by the first Java call
+			} });
+		break;
+	case JNIWrapperConfig::StartMode::Lazy:
+		break;
+	}
 }
 
 JNIWrapper::~JNIWrapper()
 {
-	if (env)
+	if (starter.joinable())
 	{
-		env->DeleteLocalRef(helloWorldClass);
-		env->DeleteLocalRef(helloWorldJNIClass);
+		starter.join();
 	}
 	if (jvm)
 	{
+		JNIEnv *env = nullptr;
+		if (jvm->GetEnv((void **)&env, JNI_VERSION_1_8) == JNI_OK)
+		{
+			env->DeleteGlobalRef(helloWorldClass);
+			env->DeleteGlobalRef(helloWorldJNIClass);
+		}
+		liveVM.store(nullptr, std::memory_order_release);
 		jvm->DestroyJavaVM();
 	}
 }
 
+void JNIWrapper::ensureStarted()
+{
+	// Runs exactly once; a failure is kept and rethrown to every caller
+	std::call_once(startOnce, [this]()
+				   {
+		try
+		{
+			initializeJVM();
+			loadJavaClasses();
+			setupMethodIDs();
+			if (config.startMode != JNIWrapperConfig::StartMode::Eager)
+			{
+				// The creating thread may be a helper or pool thread rather
+				// than the one that destroys the VM. JNI_CreateJavaVM attached
+				// it as non-daemon, which would make DestroyJavaVM wait for it:
+				// re-attach it as a daemon that detaches when it exits.
+				jvm->DetachCurrentThread();
+				threadAttachment.env = nullptr;
+				currentEnv();
+			}
+		}
+		catch (...)
+		{
+			startError = std::current_exception();
+			if (jvm && config.startMode != JNIWrapperConfig::StartMode::Eager)
+			{
+				// Same reason: the destructor still destroys this VM
+				jvm->DetachCurrentThread();
+				threadAttachment.env = nullptr;
+			}
+		} });
+	if (startError)
+	{
+		std::rethrow_exception(startError);
+	}
+}
+
 void JNIWrapper::initializeJVM()
 {
-	JavaVMOption options[1];
-	options[0].optionString = const_cast<char *>("-Djava.class.path=java_hello_lib-1.0.0.jar");
+	std::vector<std::string> optionStrings;
+	optionStrings.push_back("-Djava.class.path=" + config.classPath);
+	if (!config.sharedArchive.empty())
+	{
+		// -Xshare:auto falls back to normal class loading if the archive is
+		// missing or was dumped for a different class path
+		optionStrings.push_back("-XX:SharedArchiveFile=" + config.sharedArchive);
+		optionStrings.push_back("-Xshare:auto");
+	}
+	optionStrings.insert(optionStrings.end(), config.jvmOptions.begin(), config.jvmOptions.end());
+
+	std::vector<JavaVMOption> options(optionStrings.size());
+	for (std::size_t i = 0; i < options.size(); ++i)
+	{
+		options[i].optionString = const_cast<char *>(optionStrings[i].c_str());
+		options[i].extraInfo = nullptr;
+	}
 
 	JavaVMInitArgs vm_args;
 	vm_args.version = JNI_VERSION_1_8;
-	vm_args.nOptions = 1;
-	vm_args.options = options;
-	vm_args.ignoreUnrecognized = JNI_FALSE;
+	vm_args.nOptions = (jint)options.size();
+	vm_args.options = options.data();
+	vm_args.ignoreUnrecognized = config.ignoreUnrecognized ? JNI_TRUE : JNI_FALSE;
 
+	JNIEnv *env = nullptr;
 	jint result = JNI_CreateJavaVM(&jvm, (void **)&env, &vm_args);
 	if (result != JNI_OK)
 	{
+		jvm = nullptr;
 		throw std::runtime_error("Failed to create Java VM");
 	}
+	liveVM.store(jvm, std::memory_order_release);
 }
 
 void JNIWrapper::loadJavaClasses()
 {
-	helloWorldClass = env->FindClass("HelloWorld");
+	// Global refs: local class refs would only be valid on this thread
+	JNIEnv *env = currentEnv();
+
+	helloWorldClass = findGlobalClass(env, "HelloWorld");
 	if (!helloWorldClass)
 	{
 		throw std::runtime_error("Failed to find HelloWorld class");
 	}
 
-	helloWorldJNIClass = env->FindClass("HelloWorldJNI");
+	helloWorldJNIClass = findGlobalClass(env, "HelloWorldJNI");
 	if (!helloWorldJNIClass)
 	{
 		throw std::runtime_error("Failed to find HelloWorldJNI class");
@@ -59,6 +197,8 @@ void JNIWrapper::loadJavaClasses()
 
 void JNIWrapper::setupMethodIDs()
 {
+	JNIEnv *env = currentEnv();
+
 	helloMethod = env->GetStaticMethodID(helloWorldClass, "hello", "()Ljava/lang/String;");
 	if (!helloMethod)
 	{
@@ -70,10 +210,59 @@ void JNIWrapper::setupMethodIDs()
 	{
 		throw std::runtime_error("Failed to find HelloWorldJNI.getVersion() method");
 	}
+
+	greetMethod = env->GetStaticMethodID(helloWorldClass, "greet", "(Ljava/lang/String;)Ljava/lang/String;");
+	if (!greetMethod)
+	{
+		throw std::runtime_error("Failed to find HelloWorld.greet() method");
+	}
+
+	greetBatchMethod = env->GetStaticMethodID(helloWorldClass, "greetBatch",
+											  "(Ljava/nio/ByteBuffer;ILjava/nio/ByteBuffer;)I");
+	if (!greetBatchMethod)
+	{
+		throw std::runtime_error("Failed to find HelloWorld.greetBatch() method");
+	}
+}
+
+JNIEnv *JNIWrapper::currentEnv()
+{
+	ThreadAttachment &attachment = threadAttachment;
+	if (attachment.env && attachment.vm == jvm)
+	{
+		return attachment.env;
+	}
+
+	JNIEnv *env = nullptr;
+	jint result = jvm->GetEnv((void **)&env, JNI_VERSION_1_8);
+	if (result == JNI_EDETACHED)
+	{
+		// Attach as a daemon so DestroyJavaVM does not wait on pool threads
+		// that are still alive when the wrapper goes away
+		if (jvm->AttachCurrentThreadAsDaemon((void **)&env, nullptr) != JNI_OK)
+		{
+			throw std::runtime_error("Failed to attach thread to Java VM");
+		}
+		attachment.attached = true;
+	}
+	else if (result != JNI_OK)
+	{
+		throw std::runtime_error("Failed to get JNIEnv for current thread");
+	}
+	else
+	{
+		attachment.attached = false;
+	}
+
+	attachment.vm = jvm;
+	attachment.env = env;
+	return env;
 }
 
 std::string JNIWrapper::callJavaHello()
 {
+	ensureStarted();
+	JNIEnv *env = currentEnv();
 	jstring jresult = (jstring)env->CallStaticObjectMethod(helloWorldClass, helloMethod);
 	if (env->ExceptionCheck())
 	{
@@ -87,6 +276,8 @@ std::string JNIWrapper::callJavaHello()
 
 std::string JNIWrapper::callJavaVersion()
 {
+	ensureStarted();
+	JNIEnv *env = currentEnv();
 	jstring jresult = (jstring)env->CallStaticObjectMethod(helloWorldJNIClass, versionMethod);
 	if (env->ExceptionCheck())
 	{
@@ -98,6 +289,129 @@ std::string JNIWrapper::callJavaVersion()
 	return jstringToString(jresult);
 }
 
+std::string JNIWrapper::callJavaGreet(const std::string &name)
+{
+	ensureStarted();
+	return jstringToString(invokeGreet(name));
+}
+
+std::string_view JNIWrapper::callJavaGreetView(const std::string &name)
+{
+	ensureStarted();
+	return jstringToView(invokeGreet(name));
+}
+
+jstring JNIWrapper::invokeGreet(const std::string &name)
+{
+	JNIEnv *env = currentEnv();
+	jstring jname = env->NewStringUTF(name.c_str());
+	if (!jname)
+	{
+		env->ExceptionClear();
+		throw std::runtime_error("Failed to create Java string");
+	}
+
+	jstring jresult = (jstring)env->CallStaticObjectMethod(helloWorldClass, greetMethod, jname);
+	env->DeleteLocalRef(jname);
+	if (env->ExceptionCheck())
+	{
+		env->ExceptionDescribe();
+		env->ExceptionClear();
+		throw std::runtime_error("Exception occurred calling Java greet() method");
+	}
+
+	return jresult;
+}
+
+std::size_t JNIWrapper::callJavaGreetBatch(const std::string *names, std::size_t count,
+										   char *buffer, std::size_t bufferSize,
+										   std::string_view *results)
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+	if (count > INT_MAX)
+	{
+		throw std::invalid_argument("Batch too large");
+	}
+	if (buffer == nullptr)
+	{
+		bufferSize = 0;
+	}
+	ensureStarted();
+
+	// Pack the names as length-prefixed records in a per-thread staging
+	// buffer; Java reads it in place through a direct ByteBuffer
+	thread_local std::vector<char> staging;
+	staging.clear();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		std::int32_t length = (std::int32_t)names[i].size();
+		std::size_t offset = staging.size();
+		staging.resize(offset + sizeof(length) + names[i].size());
+		std::memcpy(staging.data() + offset, &length, sizeof(length));
+		std::memcpy(staging.data() + offset + sizeof(length), names[i].data(), names[i].size());
+	}
+
+	JNIEnv *env = currentEnv();
+	jlong capacity = bufferSize > INT_MAX ? INT_MAX : (jlong)bufferSize;
+	jobject in = env->NewDirectByteBuffer(staging.data(), (jlong)staging.size());
+	jobject out = env->NewDirectByteBuffer(buffer ? buffer : staging.data(), capacity);
+	if (!in || !out)
+	{
+		env->ExceptionClear();
+		env->DeleteLocalRef(in);
+		env->DeleteLocalRef(out);
+		throw std::runtime_error("Failed to create direct ByteBuffer");
+	}
+
+	jint needed = env->CallStaticIntMethod(helloWorldClass, greetBatchMethod, in, (jint)count, out);
+	env->DeleteLocalRef(in);
+	env->DeleteLocalRef(out);
+	if (env->ExceptionCheck())
+	{
+		env->ExceptionDescribe();
+		env->ExceptionClear();
+		throw std::runtime_error("Exception occurred calling Java greetBatch() method");
+	}
+	if (needed < 0)
+	{
+		// greetBatch sums record sizes in a Java int; negative means it wrapped
+		throw std::runtime_error("greetBatch() result size overflowed");
+	}
+
+	if ((std::size_t)needed <= bufferSize)
+	{
+		const char *cursor = buffer;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			std::int32_t length;
+			std::memcpy(&length, cursor, sizeof(length));
+			results[i] = std::string_view(cursor + sizeof(length), (std::size_t)length);
+			cursor += sizeof(length) + length;
+		}
+	}
+
+	return (std::size_t)needed;
+}
+
+// Decodes jstr (modified UTF-8, as GetStringUTFChars would give) straight
+// into out with GetStringUTFRegion: one copy, and no JVM-side buffer to
+// allocate and release. out keeps its capacity, so reused buffers only grow.
+void JNIWrapper::decodeString(jstring jstr, std::string &out)
+{
+	JNIEnv *env = currentEnv();
+	jsize length = env->GetStringLength(jstr);
+	std::size_t utfLength = (std::size_t)env->GetStringUTFLength(jstr);
+
+	// HotSpot NUL-terminates the region, so leave room for it
+	out.resize(utfLength + 1);
+	env->GetStringUTFRegion(jstr, 0, length, out.data());
+	out.resize(utfLength);
+	env->DeleteLocalRef(jstr);
+}
+
 std::string JNIWrapper::jstringToString(jstring jstr)
 {
 	if (!jstr)
@@ -105,10 +419,19 @@ std::string JNIWrapper::jstringToString(jstring jstr)
 		return "";
 	}
 
-	const char *cstr = env->GetStringUTFChars(jstr, nullptr);
-	std::string result(cstr);
-	env->ReleaseStringUTFChars(jstr, cstr);
-	env->DeleteLocalRef(jstr);
-
+	std::string result;
+	decodeString(jstr, result);
 	return result;
 }
+
+std::string_view JNIWrapper::jstringToView(jstring jstr)
+{
+	if (!jstr)
+	{
+		return {};
+	}
+
+	thread_local std::string buffer;
+	decodeString(jstr, buffer);
+	return buffer;
+}
@@ -1,28 +1,83 @@
 #pragma once
 
+#include <cstddef>
+#include <exception>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 #include <jni.h>
 
+// How JNIWrapper boots its JVM
+struct JNIWrapperConfig
+{
+	enum class StartMode
+	{
+		Eager,     // create the JVM in the constructor
+		Lazy,      // create it on the first Java call
+		Background // create it on a helper thread; first Java call waits for it
+	};
+
+	std::string classPath = "java_hello_lib-1.0.0.jar";
+	std::string sharedArchive;			 // AppCDS archive to map, empty for none
+	std::vector<std::string> jvmOptions; // passed to the JVM as-is
+	bool ignoreUnrecognized = false;
+	StartMode startMode = StartMode::Eager;
+
+	// Background start with the build's AppCDS archive and a JIT/GC setup
+	// suited to short-lived processes
+	static JNIWrapperConfig fastStartup();
+};
+
+// Safe to share between threads: each calling thread gets its own JNIEnv,
+// attached on first use and detached again when the thread exits
 class JNIWrapper
 {
 private:
+	JNIWrapperConfig config;
+	std::once_flag startOnce;
+	std::exception_ptr startError;
+	std::thread starter;
+
 	JavaVM *jvm;
-	JNIEnv *env;
 	jclass helloWorldClass;
 	jclass helloWorldJNIClass;
 	jmethodID helloMethod;
 	jmethodID versionMethod;
+	jmethodID greetMethod;
+	jmethodID greetBatchMethod;
 
 public:
-	JNIWrapper();
+	explicit JNIWrapper(JNIWrapperConfig config = JNIWrapperConfig());
 	~JNIWrapper();
 
 	std::string callJavaHello();
 	std::string callJavaVersion();
+	std::string callJavaGreet(const std::string &name);
+
+	// Same as callJavaGreet but decodes into a per-thread buffer that is
+	// reused across calls, so large results skip the allocation. The view is
+	// valid until the calling thread's next callJavaGreetView().
+	std::string_view callJavaGreetView(const std::string &name);
+
+	// Greets count names with a single JNI call. The greetings are written
+	// into buffer (each behind a 4-byte length) and results[i] views the i-th
+	// one. Returns the buffer size the whole batch needs; if that is larger
+	// than bufferSize, results is left untouched and the call can be retried
+	// with a bigger buffer.
+	std::size_t callJavaGreetBatch(const std::string *names, std::size_t count,
+								   char *buffer, std::size_t bufferSize,
+								   std::string_view *results);
 
 private:
+	void ensureStarted();
 	void initializeJVM();
 	void loadJavaClasses();
 	void setupMethodIDs();
+	JNIEnv *currentEnv();
+	jstring invokeGreet(const std::string &name);
+	void decodeString(jstring jstr, std::string &out);
 	std::string jstringToString(jstring jstr);
+	std::string_view jstringToView(jstring jstr);
 };
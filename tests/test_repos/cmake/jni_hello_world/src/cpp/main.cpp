@@ -1,7 +1,29 @@
 #include <iostream>
 #include <jni.h>
-#include <windows.h>
 #include "jni_wrapper.h"
+#include "plugin_loader.h"
+
+// Exports of the Go shared library built by add_go_shared_library
+struct HelloGoApi
+{
+	void (*helloGo)();
+};
+
+static void resolveHelloGo(const NativeLibrary &library, HelloGoApi &api)
+{
+	api.helloGo = library.function<void (*)()>("HelloGo");
+}
+
+static std::string helloGoLibraryPath()
+{
+	// Like the JVM classpath, the library is looked up relative to the
+	// working directory; POSIX dlopen needs the explicit "./" for that
+#ifdef _WIN32
+	return NativeLibrary::platformFileName("libhello");
+#else
+	return "./" + NativeLibrary::platformFileName("libhello");
+#endif
+}
 
 int main()
 {
@@ -9,8 +31,9 @@ int main()
 
 	try
 	{
-		// Initialize JNI wrapper
-		JNIWrapper jni_wrapper;
+		// Initialize JNI wrapper; the JVM boots in the background from the
+		// AppCDS archive and the first call below waits for it
+		JNIWrapper jni_wrapper(JNIWrapperConfig::fastStartup());
 
 		// Call Java HelloWorld.hello() method
 		std::string result = jni_wrapper.callJavaHello();
@@ -26,31 +49,22 @@ int main()
 		return 1;
 	}
 
-	// Load and call Go shared library
+	// Load the Go shared library and resolve its exports once, up front
 	std::cout << "\nLoading Go shared library..." << std::endl;
-	HMODULE hGoLib = LoadLibrary(TEXT("libhello.dll"));
-	if (hGoLib == NULL)
+	Plugin<HelloGoApi> goLibrary(helloGoLibraryPath(), resolveHelloGo);
+	try
 	{
-		std::cerr << "Failed to load libhello.dll" << std::endl;
-		return 1;
-	}
+		goLibrary.preload();
 
-	// Get function pointer to HelloGo
-	typedef void (*HelloGoFunc)();
-	HelloGoFunc helloGo = (HelloGoFunc)GetProcAddress(hGoLib, "HelloGo");
-	if (helloGo == NULL)
+		// Call the Go function
+		goLibrary.api().helloGo();
+	}
+	catch (const std::exception &e)
 	{
-		std::cerr << "Failed to find HelloGo function" << std::endl;
-		FreeLibrary(hGoLib);
+		std::cerr << "Error: " << e.what() << std::endl;
 		return 1;
 	}
 
-	// Call the Go function
-	helloGo();
-
-	// Clean up
-	FreeLibrary(hGoLib);
-
 	std::cout << "Application completed successfully!" << std::endl;
 	return 0;
 }
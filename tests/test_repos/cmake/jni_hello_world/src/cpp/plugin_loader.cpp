@@ -0,0 +1,105 @@
+#include "plugin_loader.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace
+{
+	std::string lastLoaderError()
+	{
+#ifdef _WIN32
+		return "error " + std::to_string(GetLastError());
+#else
+		const char *message = dlerror();
+		return message != nullptr ? message : "unknown error";
+#endif
+	}
+}
+
+NativeLibrary::NativeLibrary(const std::string &path, Binding binding) : path(path), handle(nullptr)
+{
+#ifdef _WIN32
+	// LoadLibrary always binds imports at load time
+	(void)binding;
+	handle = reinterpret_cast<void *>(LoadLibraryA(path.c_str()));
+#else
+	handle = dlopen(path.c_str(), (binding == Binding::Now ? RTLD_NOW : RTLD_LAZY) | RTLD_LOCAL);
+#endif
+	if (handle == nullptr)
+	{
+		throw std::runtime_error("Failed to load " + path + ": " + lastLoaderError());
+	}
+}
+
+NativeLibrary::~NativeLibrary()
+{
+	close();
+}
+
+NativeLibrary::NativeLibrary(NativeLibrary &&other) noexcept
+	: path(std::move(other.path)), handle(std::exchange(other.handle, nullptr))
+{
+}
+
+NativeLibrary &NativeLibrary::operator=(NativeLibrary &&other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		path = std::move(other.path);
+		handle = std::exchange(other.handle, nullptr);
+	}
+	return *this;
+}
+
+void NativeLibrary::close() noexcept
+{
+	if (handle != nullptr)
+	{
+#ifdef _WIN32
+		FreeLibrary(reinterpret_cast<HMODULE>(handle));
+#else
+		dlclose(handle);
+#endif
+		handle = nullptr;
+	}
+}
+
+void *NativeLibrary::findSymbol(const char *name) const noexcept
+{
+	if (handle == nullptr)
+	{
+		return nullptr;
+	}
+#ifdef _WIN32
+	return reinterpret_cast<void *>(GetProcAddress(reinterpret_cast<HMODULE>(handle), name));
+#else
+	return dlsym(handle, name);
+#endif
+}
+
+void *NativeLibrary::symbol(const char *name) const
+{
+	void *address = findSymbol(name);
+	if (address == nullptr)
+	{
+		throw std::runtime_error(std::string("Failed to find ") + name + " in " + path);
+	}
+	return address;
+}
+
+std::string NativeLibrary::platformFileName(const std::string &baseName)
+{
+#if defined(_WIN32)
+	return baseName + ".dll";
+#elif defined(__APPLE__)
+	return baseName + ".dylib";
+#else
+	return baseName + ".so";
+#endif
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+// A shared library opened with dlopen (POSIX) or LoadLibrary (Windows).
+// Closed again when the object is destroyed.
+class NativeLibrary
+{
+public:
+	enum class Binding
+	{
+		Now, // resolve every symbol at load time (RTLD_NOW) so failures show up early
+		Lazy // resolve each symbol on first use (RTLD_LAZY)
+	};
+
+	explicit NativeLibrary(const std::string &path, Binding binding = Binding::Now);
+	~NativeLibrary();
+
+	NativeLibrary(const NativeLibrary &) = delete;
+	NativeLibrary &operator=(const NativeLibrary &) = delete;
+	NativeLibrary(NativeLibrary &&other) noexcept;
+	NativeLibrary &operator=(NativeLibrary &&other) noexcept;
+
+	// Address of an exported symbol; throws if it is missing
+	void *symbol(const char *name) const;
+
+	// Address of an exported symbol, or nullptr if it is missing
+	void *findSymbol(const char *name) const noexcept;
+
+	template <typename Function>
+	Function function(const char *name) const
+	{
+		return reinterpret_cast<Function>(symbol(name));
+	}
+
+	// "libhello" -> "libhello.dll", "libhello.so" or "libhello.dylib"
+	static std::string platformFileName(const std::string &baseName);
+
+private:
+	void close() noexcept;
+
+	std::string path;
+	void *handle;
+};
+
+// A library plus a typed table of its exports. The library is opened and
+// every entry resolved exactly once, on the first api() call or an explicit
+// preload(); after that calls go straight through the table's pointers.
+template <typename Table>
+class Plugin
+{
+public:
+	using Resolver = void (*)(const NativeLibrary &library, Table &table);
+
+	Plugin(std::string path, Resolver resolver, NativeLibrary::Binding binding = NativeLibrary::Binding::Now)
+		: path(std::move(path)), resolver(resolver), binding(binding)
+	{
+	}
+
+	Plugin(const Plugin &) = delete;
+	Plugin &operator=(const Plugin &) = delete;
+
+	// Resolved function table; throws the load error on every call if
+	// loading failed
+	const Table &api()
+	{
+		std::call_once(loadOnce, [this]()
+					   {
+			try
+			{
+				library = std::make_unique<NativeLibrary>(path, binding);
+				resolver(*library, table);
+			}
+			catch (...)
+			{
+				library.reset();
+				loadError = std::current_exception();
+			} });
+		if (loadError)
+		{
+			std::rethrow_exception(loadError);
+		}
+		return table;
+	}
+
+	// Load at startup instead of on the first call
+	void preload()
+	{
+		api();
+	}
+
+private:
+	std::string path;
+	Resolver resolver;
+	NativeLibrary::Binding binding;
+
+	std::once_flag loadOnce;
+	std::exception_ptr loadError;
+	std::unique_ptr<NativeLibrary> library;
+	Table table{};
+};
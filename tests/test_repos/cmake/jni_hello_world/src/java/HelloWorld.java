@@ -1,9 +1,24 @@
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+
 /**
  * HelloWorld Java class - provides a simple hello world method
  * that can be called from C++ via JNI
  */
 public class HelloWorld {
 
+	/**
+	 * Entry point of the jar; also the AppCDS training run, so it touches the
+	 * classes the native wrapper loads
+	 * 
+	 * @param args Unused
+	 */
+	public static void main(String[] args) {
+		System.out.println(hello());
+		System.out.println(HelloWorldJNI.getVersion());
+	}
+
 	/**
 	 * Returns a hello world message
 	 * 
@@ -23,6 +38,41 @@ public class HelloWorld {
 		return "Hello " + name + " from Java!";
 	}
 
+	/**
+	 * Greets a batch of names in one call, so native callers pay a single JNI
+	 * transition for the whole batch. Both buffers hold records of a native
+	 * byte order int length followed by that many UTF-8 bytes. Results are
+	 * written to out only while they fit; the return value is always the
+	 * number of bytes all results need.
+	 * 
+	 * @param in    Buffer holding count name records
+	 * @param count Number of records in the input buffer
+	 * @param out   Buffer receiving the greeting records
+	 * @return Total size in bytes of the greeting records
+	 */
+	public static int greetBatch(ByteBuffer in, int count, ByteBuffer out) {
+		in.order(ByteOrder.nativeOrder());
+		out.order(ByteOrder.nativeOrder());
+
+		int needed = 0;
+		boolean fits = true;
+		for (int i = 0; i < count; i++) {
+			byte[] name = new byte[in.getInt()];
+			in.get(name);
+
+			byte[] greeting = greet(new String(name, StandardCharsets.UTF_8))
+					.getBytes(StandardCharsets.UTF_8);
+			needed += Integer.BYTES + greeting.length;
+			if (fits && out.remaining() >= Integer.BYTES + greeting.length) {
+				out.putInt(greeting.length);
+				out.put(greeting);
+			} else {
+				fits = false;
+			}
+		}
+		return needed;
+	}
+
 	/**
 	 * Returns the current Java version
 	 * 
@@ -0,0 +1,68 @@
+#include "jni_wrapper.h"
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Background start: the constructor returns at once and the first Java calls,
+// from main and from other threads, wait for the helper thread's start
+int main()
+{
+	std::cout << "Running JNI Wrapper Background Start Tests..." << std::endl;
+
+	try
+	{
+		JNIWrapperConfig config;
+		config.startMode = JNIWrapperConfig::StartMode::Background;
+
+		{
+			JNIWrapper wrapper(config);
+
+			// Test 1: Calls Racing The Start
+			std::cout << "Test 1: Calls Racing The Start..." << std::endl;
+			std::atomic<int> failures{0};
+			std::vector<std::thread> threads;
+			for (int i = 0; i < 4; ++i)
+			{
+				threads.emplace_back([&wrapper, &failures]()
+									 {
+					try
+					{
+						if (wrapper.callJavaHello().empty())
+						{
+							++failures;
+						}
+					}
+					catch (const std::exception &)
+					{
+						++failures;
+					} });
+			}
+			std::string result = wrapper.callJavaHello();
+			assert(result.find("Hello from Java") != std::string::npos);
+			for (auto &thread : threads)
+			{
+				thread.join();
+			}
+			assert(failures == 0);
+			std::cout << "✅ Calls waited for the background start: " << result << std::endl;
+
+			// Test 2: Calls After The Start
+			std::cout << "Test 2: Calls After The Start..." << std::endl;
+			std::string greeting = wrapper.callJavaGreet("Background");
+			assert(greeting.find("Background") != std::string::npos);
+			std::cout << "✅ Later call successful: " << greeting << std::endl;
+		}
+
+		std::cout << "✅ JVM destroyed on main" << std::endl;
+		std::cout << "\n🎉 All background start tests passed!" << std::endl;
+		return 0;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << "❌ Test failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
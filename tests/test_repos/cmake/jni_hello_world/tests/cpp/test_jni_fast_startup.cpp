@@ -0,0 +1,35 @@
+#include "jni_wrapper.h"
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+
+// fastStartup() must still work when its AppCDS archive is missing:
+// -Xshare:auto falls back to normal class loading
+int main()
+{
+	std::cout << "Running JNI Wrapper Fast Startup Tests..." << std::endl;
+
+	try
+	{
+		// Test 1: Missing Shared Archive
+		std::cout << "Test 1: Missing Shared Archive..." << std::endl;
+		JNIWrapperConfig config = JNIWrapperConfig::fastStartup();
+		assert(config.startMode == JNIWrapperConfig::StartMode::Background);
+		config.sharedArchive = "missing_java_hello_lib.jsa";
+
+		JNIWrapper wrapper(config);
+		std::string result = wrapper.callJavaHello();
+		assert(result.find("Hello from Java") != std::string::npos);
+		std::string greeting = wrapper.callJavaGreet("Fast");
+		assert(greeting.find("Fast") != std::string::npos);
+		std::cout << "✅ Started without the archive: " << result << std::endl;
+
+		std::cout << "\n🎉 All fast startup tests passed!" << std::endl;
+		return 0;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << "❌ Test failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,70 @@
+#include "jni_wrapper.h"
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Lazy start from a worker pool: the JVM is created by whichever pool thread
+// calls into Java first, and destroyed later on main once the pool is gone
+int main()
+{
+	std::cout << "Running JNI Wrapper Lazy Start Tests..." << std::endl;
+
+	try
+	{
+		JNIWrapperConfig config;
+		config.startMode = JNIWrapperConfig::StartMode::Lazy;
+
+		{
+			JNIWrapper wrapper(config);
+
+			// Test 1: First Call From A Pool Thread
+			std::cout << "Test 1: First Call From A Pool Thread..." << std::endl;
+			std::atomic<int> failures{0};
+			std::vector<std::thread> pool;
+			for (int i = 0; i < 4; ++i)
+			{
+				pool.emplace_back([&wrapper, &failures, i]()
+								  {
+					try
+					{
+						std::string name = "Worker" + std::to_string(i);
+						std::string greeting = wrapper.callJavaGreet(name);
+						if (greeting.find(name) == std::string::npos)
+						{
+							++failures;
+						}
+					}
+					catch (const std::exception &)
+					{
+						++failures;
+					} });
+			}
+			for (auto &thread : pool)
+			{
+				thread.join();
+			}
+			assert(failures == 0);
+			std::cout << "✅ Pool threads started the JVM" << std::endl;
+
+			// Test 2: Main Thread After The Pool Exits
+			std::cout << "Test 2: Main Thread After The Pool Exits..." << std::endl;
+			std::string version = wrapper.callJavaVersion();
+			assert(version.length() > 0);
+			std::cout << "✅ Main thread call successful: " << version << std::endl;
+		}
+
+		// Reaching here means DestroyJavaVM did not wait on the pool thread
+		// that created the VM
+		std::cout << "✅ JVM destroyed on main" << std::endl;
+		std::cout << "\n🎉 All lazy start tests passed!" << std::endl;
+		return 0;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << "❌ Test failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,69 @@
+#include "jni_wrapper.h"
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+	// True if the call threw the start failure
+	template <typename Call>
+	bool throwsStartError(Call call)
+	{
+		try
+		{
+			call();
+		}
+		catch (const std::runtime_error &e)
+		{
+			return std::string(e.what()).find("HelloWorld") != std::string::npos;
+		}
+		return false;
+	}
+}
+
+// A failed background start is kept and rethrown to every later caller,
+// on any thread, instead of retrying or crashing
+int main()
+{
+	std::cout << "Running JNI Wrapper Start Error Tests..." << std::endl;
+
+	try
+	{
+		JNIWrapperConfig config;
+		config.classPath = "does_not_exist.jar";
+		config.startMode = JNIWrapperConfig::StartMode::Background;
+
+		{
+			JNIWrapper wrapper(config);
+
+			// Test 1: First Call Rethrows
+			std::cout << "Test 1: First Call Rethrows..." << std::endl;
+			assert(throwsStartError([&]()
+									{ wrapper.callJavaHello(); }));
+			std::cout << "✅ First call rethrew the start error" << std::endl;
+
+			// Test 2: Later Calls Rethrow
+			std::cout << "Test 2: Later Calls Rethrow..." << std::endl;
+			assert(throwsStartError([&]()
+									{ wrapper.callJavaGreet("Again"); }));
+			std::atomic<bool> threw{false};
+			std::thread other([&]()
+							  { threw = throwsStartError([&]()
+														 { wrapper.callJavaVersion(); }); });
+			other.join();
+			assert(threw);
+			std::cout << "✅ Every caller sees the same error" << std::endl;
+		}
+
+		std::cout << "✅ Failed wrapper destroyed cleanly" << std::endl;
+		std::cout << "\n🎉 All start error tests passed!" << std::endl;
+		return 0;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << "❌ Test failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -2,6 +2,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 int main()
 {
@@ -41,6 +44,67 @@ int main()
 		}
 		std::cout << "✅ Multiple calls successful" << std::endl;
 
+		// Test 5: Concurrent Calls
+		std::cout << "Test 5: Concurrent Calls..." << std::endl;
+		std::atomic<int> failures{0};
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&wrapper, &failures]()
+								 {
+				try
+				{
+					for (int i = 0; i < 100; ++i)
+					{
+						if (wrapper.callJavaHello().find("Hello from Java") == std::string::npos ||
+							wrapper.callJavaVersion().find("v1.0.0") == std::string::npos)
+						{
+							++failures;
+						}
+					}
+				}
+				catch (const std::exception &)
+				{
+					++failures;
+				} });
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+		assert(failures == 0);
+		std::cout << "✅ Concurrent calls successful" << std::endl;
+
+		// Test 6: Batched Greet Call
+		std::cout << "Test 6: Batched Greet Call..." << std::endl;
+		std::string names[] = {"Ada", "Grace", ""};
+		std::string_view greetings[3];
+		std::vector<char> buffer(8);
+		std::size_t needed = wrapper.callJavaGreetBatch(names, 3, nullptr, 1024, greetings);
+		assert(needed == wrapper.callJavaGreetBatch(names, 3, buffer.data(), buffer.size(), greetings));
+		assert(needed > buffer.size());
+		buffer.resize(needed);
+		std::size_t written = wrapper.callJavaGreetBatch(names, 3, buffer.data(), buffer.size(), greetings);
+		assert(written == needed);
+		for (int i = 0; i < 3; ++i)
+		{
+			std::string expected = wrapper.callJavaGreet(names[i]);
+			assert(greetings[i] == expected);
+		}
+		std::cout << "✅ Batched greet call successful: " << greetings[0] << std::endl;
+
+		// Test 7: Large String Views
+		std::cout << "Test 7: Large String Views..." << std::endl;
+		std::string large(1 << 20, 'x');
+		std::string copied = wrapper.callJavaGreet(large);
+		assert(copied.size() > large.size());
+		std::string viewed(wrapper.callJavaGreetView(large));
+		assert(viewed == copied);
+		std::string short_view(wrapper.callJavaGreetView("Ada"));
+		std::string short_copy = wrapper.callJavaGreet("Ada");
+		assert(short_view == short_copy);
+		std::cout << "✅ Large string views successful" << std::endl;
+
 		std::cout << "\n🎉 All JNI Wrapper tests passed!" << std::endl;
 		return 0;
 	}
@@ -0,0 +1,114 @@
+#include "plugin_loader.h"
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#ifndef HELLO_GO_LIBRARY_PATH
+#define HELLO_GO_LIBRARY_PATH "libhello"
+#endif
+
+struct HelloGoApi
+{
+	void (*helloGo)();
+};
+
+static std::atomic<int> resolveCount{0};
+
+static void resolveHelloGo(const NativeLibrary &library, HelloGoApi &api)
+{
+	resolveCount.fetch_add(1);
+	api.helloGo = library.function<void (*)()>("HelloGo");
+}
+
+static void resolveMissing(const NativeLibrary &library, HelloGoApi &api)
+{
+	api.helloGo = library.function<void (*)()>("NoSuchExport");
+}
+
+int main()
+{
+	std::cout << "Running Plugin Loader Tests..." << std::endl;
+
+	try
+	{
+		// Test 1: Load Library and Resolve Symbol
+		std::cout << "Test 1: Load Library and Resolve Symbol..." << std::endl;
+		{
+			NativeLibrary library(HELLO_GO_LIBRARY_PATH);
+			void *hello = library.findSymbol("HelloGo");
+			void *missing = library.findSymbol("NoSuchExport");
+			assert(hello != nullptr);
+			assert(missing == nullptr);
+			library.function<void (*)()>("HelloGo")();
+		}
+		std::cout << "✅ HelloGo resolved and called" << std::endl;
+
+		// Test 2: Lazy Binding
+		std::cout << "Test 2: Lazy Binding..." << std::endl;
+		{
+			NativeLibrary library(HELLO_GO_LIBRARY_PATH, NativeLibrary::Binding::Lazy);
+			void *hello = library.findSymbol("HelloGo");
+			assert(hello != nullptr);
+		}
+		std::cout << "✅ Lazy binding successful" << std::endl;
+
+		// Test 3: Missing Library and Symbol Errors
+		std::cout << "Test 3: Missing Library and Symbol Errors..." << std::endl;
+		bool threw = false;
+		try
+		{
+			NativeLibrary missing("./no_such_library" + NativeLibrary::platformFileName(""));
+		}
+		catch (const std::runtime_error &)
+		{
+			threw = true;
+		}
+		assert(threw);
+
+		Plugin<HelloGoApi> broken(HELLO_GO_LIBRARY_PATH, resolveMissing);
+		for (int i = 0; i < 2; ++i)
+		{
+			threw = false;
+			try
+			{
+				broken.api();
+			}
+			catch (const std::runtime_error &e)
+			{
+				threw = std::string(e.what()).find("NoSuchExport") != std::string::npos;
+			}
+			assert(threw);
+		}
+		std::cout << "✅ Load errors reported" << std::endl;
+
+		// Test 4: Function Table Resolved Once
+		std::cout << "Test 4: Function Table Resolved Once..." << std::endl;
+		Plugin<HelloGoApi> plugin(HELLO_GO_LIBRARY_PATH, resolveHelloGo);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&plugin]()
+								 {
+				const HelloGoApi &api = plugin.api();
+				assert(api.helloGo != nullptr); });
+		}
+		for (auto &thread : threads)
+		{
+			thread.join();
+		}
+		plugin.preload();
+		assert(resolveCount.load() == 1);
+		std::cout << "✅ Function table resolved once" << std::endl;
+
+		std::cout << "\n🎉 All Plugin Loader tests passed!" << std::endl;
+		return 0;
+	}
+	catch (const std::exception &e)
+	{
+		std::cerr << "❌ Test failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
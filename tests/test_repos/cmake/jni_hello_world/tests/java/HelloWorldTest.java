@@ -1,3 +1,7 @@
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+
 import org.junit.Test;
 import org.junit.Before;
 import static org.junit.Assert.*;
@@ -37,6 +41,35 @@ public class HelloWorldTest {
 				result.contains("from Java"));
 	}
 
+	@Test
+	public void testHelloWorldGreetBatch() {
+		// Test HelloWorld.greetBatch() against per-name greet()
+		String[] names = { "Ada", "Grace", "" };
+		ByteBuffer in = ByteBuffer.allocateDirect(64).order(ByteOrder.nativeOrder());
+		for (String name : names) {
+			byte[] bytes = name.getBytes(StandardCharsets.UTF_8);
+			in.putInt(bytes.length);
+			in.put(bytes);
+		}
+		in.flip();
+
+		ByteBuffer out = ByteBuffer.allocateDirect(256).order(ByteOrder.nativeOrder());
+		int needed = HelloWorld.greetBatch(in, names.length, out);
+		assertEquals("Batch should fill exactly the bytes it reports", out.position(), needed);
+
+		out.flip();
+		for (String name : names) {
+			byte[] bytes = new byte[out.getInt()];
+			out.get(bytes);
+			assertEquals(HelloWorld.greet(name), new String(bytes, StandardCharsets.UTF_8));
+		}
+
+		// A buffer that is too small still reports the full size
+		in.rewind();
+		ByteBuffer small = ByteBuffer.allocateDirect(8);
+		assertEquals(needed, HelloWorld.greetBatch(in, names.length, small));
+	}
+
 	@Test
 	public void testHelloWorldGetJavaVersion() {
 		// Test HelloWorld.getJavaVersion() method
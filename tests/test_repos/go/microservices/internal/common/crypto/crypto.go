@@ -1,7 +1,7 @@
 package crypto
 
 /*
-#include "crypto_utils.c"
+#include "crypto_utils.h"
 #include <stdlib.h>
 */
 import "C"
@@ -9,7 +9,6 @@ import (
 	"crypto/rand"
 	"crypto/sha256"
 	"encoding/hex"
-	"errors"
 	"golang.org/x/crypto/bcrypt"
 	"unsafe"
 )
@@ -42,13 +41,63 @@ func SHA256Hash(input string) string {
 }
 
 // SimpleHash computes a simple hash using C implementation (for demonstration)
-// This uses CGo to call C code, demonstrating cross-language integration
+// This uses CGo to call C code, demonstrating cross-language integration.
+// It is the byte sum of input, so permutations collide; use HashString for a
+// well-distributed hash.
 func SimpleHash(input string) int {
 	cInput := C.CString(input)
 	defer C.free(unsafe.Pointer(cInput))
 	return int(C.simple_hash(cInput))
 }
 
+// Hash computes a fast, well-distributed 64-bit hash of data using the
+// vectorized C implementation. It is not a cryptographic hash.
+func Hash(data []byte) uint64 {
+	return HashSeed(data, 0)
+}
+
+// HashSeed is Hash with a caller-chosen seed
+func HashSeed(data []byte, seed uint64) uint64 {
+	if len(data) == 0 {
+		return uint64(C.hash_bytes(nil, 0, C.uint64_t(seed)))
+	}
+	return uint64(C.hash_bytes(unsafe.Pointer(&data[0]), C.size_t(len(data)), C.uint64_t(seed)))
+}
+
+// HashString is Hash for strings, without copying them
+func HashString(input string) uint64 {
+	if len(input) == 0 {
+		return uint64(C.hash_bytes(nil, 0, 0))
+	}
+	return uint64(C.hash_bytes(unsafe.Pointer(unsafe.StringData(input)), C.size_t(len(input)), 0))
+}
+
+// HashBatch hashes every input in a single cgo call. The inputs are packed
+// into one buffer first, which costs far less than a cgo call per input.
+func HashBatch(inputs [][]byte, seed uint64) []uint64 {
+	if len(inputs) == 0 {
+		return nil
+	}
+	total := 0
+	for _, input := range inputs {
+		total += len(input)
+	}
+	packed := make([]byte, 0, total)
+	lengths := make([]C.size_t, len(inputs))
+	for i, input := range inputs {
+		packed = append(packed, input...)
+		lengths[i] = C.size_t(len(input))
+	}
+
+	var data *C.uchar
+	if total > 0 {
+		data = (*C.uchar)(&packed[0])
+	}
+	hashes := make([]uint64, len(inputs))
+	C.hash_bytes_batch(data, &lengths[0], C.size_t(len(inputs)), C.uint64_t(seed), (*C.uint64_t)(&hashes[0]))
+	return hashes
+}
+
 // XOREncrypt performs XOR encryption using C implementation
 func XOREncrypt(input []byte, key byte) []byte {
 	if len(input) == 0 {
@@ -58,9 +107,54 @@ func XOREncrypt(input []byte, key byte) []byte {
 	C.xor_encrypt(
 		(*C.uchar)(&input[0]),
 		(*C.uchar)(&output[0]),
-		C.int(len(input)),
+		C.size_t(len(input)),
 		C.uchar(key),
 	)
 	return output
 }
 
+// XOREncryptBatch encrypts every input in a single cgo call. With one key
+// for all inputs, XOR of the concatenation is the concatenation of the
+// XORs, so the inputs are copied into one shared output allocation and
+// encrypted there in place.
+func XOREncryptBatch(inputs [][]byte, key byte) [][]byte {
+	if len(inputs) == 0 {
+		return nil
+	}
+	total := 0
+	for _, input := range inputs {
+		total += len(input)
+	}
+	outputs := make([][]byte, len(inputs))
+	if total == 0 {
+		return outputs
+	}
+
+	backing := make([]byte, 0, total)
+	for i, input := range inputs {
+		if len(input) > 0 {
+			start := len(backing)
+			backing = append(backing, input...)
+			outputs[i] = backing[start:len(backing):len(backing)]
+		}
+	}
+
+	C.xor_encrypt(
+		(*C.uchar)(&backing[0]),
+		(*C.uchar)(&backing[0]),
+		C.size_t(total),
+		C.uchar(key),
+	)
+	return outputs
+}
+
+// setSIMDLevel forces the C kernel family (CRYPTO_SIMD_*); used by the tests
+// to check every kernel the CPU supports against the scalar one
+func setSIMDLevel(level int) bool {
+	return C.crypto_set_simd_level(C.int(level)) == 0
+}
+
+// simdLevel reports the C kernel family in use
+func simdLevel() int {
+	return int(C.crypto_simd_level())
+}
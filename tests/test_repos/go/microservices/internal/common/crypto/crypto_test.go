@@ -1,6 +1,10 @@
 package crypto
 
-import "testing"
+import (
+	"bytes"
+	"math/bits"
+	"testing"
+)
 
 func TestHashPassword(t *testing.T) {
 	hash, err := HashPassword("testpassword")
@@ -21,3 +25,123 @@ func TestCheckPasswordHash(t *testing.T) {
 		t.Error("CheckPasswordHash succeeded for wrong password")
 	}
 }
+
+func TestSimpleHashIsByteSum(t *testing.T) {
+	if got := SimpleHash("abc"); got != 'a'+'b'+'c' {
+		t.Errorf("SimpleHash(\"abc\") = %d, want %d", got, 'a'+'b'+'c')
+	}
+	if got := SimpleHash(""); got != 0 {
+		t.Errorf("SimpleHash(\"\") = %d, want 0", got)
+	}
+}
+
+func TestXOREncryptRoundTrip(t *testing.T) {
+	input := make([]byte, 1000)
+	for i := range input {
+		input[i] = byte(i * 7)
+	}
+	for _, n := range []int{1, 7, 16, 63, 129, 1000} {
+		encrypted := XOREncrypt(input[:n], 0x5a)
+		if got := XOREncrypt(encrypted, 0x5a); !bytes.Equal(got, input[:n]) {
+			t.Fatalf("XOREncrypt round trip failed for length %d", n)
+		}
+	}
+}
+
+func TestSIMDKernelsMatchScalar(t *testing.T) {
+	data := make([]byte, 5000)
+	for i := range data {
+		data[i] = byte(i*31 + i>>3)
+	}
+	defer setSIMDLevel(simdLevel())
+
+	for n := 0; n < len(data); n += 1 + n/8 {
+		setSIMDLevel(0)
+		wantHash := HashSeed(data[:n], 42)
+		wantXOR := XOREncrypt(data[:n], 0xa5)
+		for level := 1; level <= 3; level++ {
+			if !setSIMDLevel(level) {
+				continue
+			}
+			if got := HashSeed(data[:n], 42); got != wantHash {
+				t.Fatalf("hash mismatch at level %d, length %d", level, n)
+			}
+			if got := XOREncrypt(data[:n], 0xa5); !bytes.Equal(got, wantXOR) {
+				t.Fatalf("xor mismatch at level %d, length %d", level, n)
+			}
+		}
+	}
+}
+
+func TestHashDistribution(t *testing.T) {
+	// Byte permutations collided under the old byte-sum hash
+	if HashString("ab") == HashString("ba") {
+		t.Error("Hash collides on permuted input")
+	}
+	if Hash([]byte("a")) == Hash([]byte("a\x00")) {
+		t.Error("Hash ignores trailing zero bytes")
+	}
+
+	// Flipping any one input bit should flip about half the output bits
+	data := make([]byte, 200)
+	base := Hash(data)
+	total := 0
+	for bit := 0; bit < len(data)*8; bit++ {
+		data[bit/8] ^= 1 << (bit % 8)
+		total += bits.OnesCount64(base ^ Hash(data))
+		data[bit/8] ^= 1 << (bit % 8)
+	}
+	if avg := float64(total) / float64(len(data)*8); avg < 28 || avg > 36 {
+		t.Errorf("poor avalanche: %.2f bits flipped on average", avg)
+	}
+}
+
+func TestBatchMatchesSingle(t *testing.T) {
+	inputs := [][]byte{[]byte("alpha"), nil, bytes.Repeat([]byte("b"), 300), []byte("gamma")}
+
+	hashes := HashBatch(inputs, 9)
+	encrypted := XOREncryptBatch(inputs, 0x33)
+	for i, input := range inputs {
+		if hashes[i] != HashSeed(input, 9) {
+			t.Errorf("HashBatch[%d] differs from HashSeed", i)
+		}
+		if !bytes.Equal(encrypted[i], XOREncrypt(input, 0x33)) {
+			t.Errorf("XOREncryptBatch[%d] differs from XOREncrypt", i)
+		}
+	}
+}
+
+func BenchmarkXOREncrypt64K(b *testing.B) {
+	data := make([]byte, 64<<10)
+	b.SetBytes(int64(len(data)))
+	for i := 0; i < b.N; i++ {
+		XOREncrypt(data, 0x5a)
+	}
+}
+
+func BenchmarkHash64K(b *testing.B) {
+	data := make([]byte, 64<<10)
+	b.SetBytes(int64(len(data)))
+	for i := 0; i < b.N; i++ {
+		Hash(data)
+	}
+}
+
+func BenchmarkHashSmall(b *testing.B) {
+	inputs := make([][]byte, 256)
+	for i := range inputs {
+		inputs[i] = []byte("request-body")
+	}
+	b.Run("single", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			for _, input := range inputs {
+				Hash(input)
+			}
+		}
+	})
+	b.Run("batch", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			HashBatch(inputs, 0)
+		}
+	})
+}
@@ -1,5 +1,18 @@
 // Simple C utility functions - no external dependencies
 
+#include "crypto_utils.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRYPTO_HAVE_X86 1
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CRYPTO_HAVE_NEON 1
+#endif
+
 // Simple hash function - returns sum of all bytes
 int simple_hash(const char* input) {
     if (!input) {
@@ -14,12 +27,381 @@ int simple_hash(const char* input) {
     return sum;
 }
 
+// ---------------------------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------------------------
+
+static int simd_supported(int level) {
+    switch (level) {
+    case CRYPTO_SIMD_SCALAR:
+        return 1;
+#if CRYPTO_HAVE_X86
+    case CRYPTO_SIMD_SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    case CRYPTO_SIMD_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+#if CRYPTO_HAVE_NEON
+    case CRYPTO_SIMD_NEON:
+        return 1;
+#endif
+    default:
+        return 0;
+    }
+}
+
+// -1 until the first call probes the CPU; every thread probes the same
+// answer, so a racing first call is harmless
+static atomic_int simd_level = -1;
+
+int crypto_simd_level(void) {
+    int level = atomic_load_explicit(&simd_level, memory_order_relaxed);
+    if (level < 0) {
+        level = CRYPTO_SIMD_SCALAR;
+        if (simd_supported(CRYPTO_SIMD_AVX2)) {
+            level = CRYPTO_SIMD_AVX2;
+        } else if (simd_supported(CRYPTO_SIMD_SSE2)) {
+            level = CRYPTO_SIMD_SSE2;
+        } else if (simd_supported(CRYPTO_SIMD_NEON)) {
+            level = CRYPTO_SIMD_NEON;
+        }
+        atomic_store_explicit(&simd_level, level, memory_order_relaxed);
+    }
+    return level;
+}
+
+int crypto_set_simd_level(int level) {
+    if (!simd_supported(level)) {
+        return -1;
+    }
+    atomic_store_explicit(&simd_level, level, memory_order_relaxed);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// XOR kernels
+// ---------------------------------------------------------------------------
+
+static void xor_scalar(const unsigned char* input, unsigned char* output, size_t length, unsigned char key) {
+    uint64_t wide_key = key * UINT64_C(0x0101010101010101);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, input + i, sizeof(word));
+        word ^= wide_key;
+        memcpy(output + i, &word, sizeof(word));
+    }
+    for (; i < length; i++) {
+        output[i] = input[i] ^ key;
+    }
+}
+
+#if CRYPTO_HAVE_X86
+__attribute__((target("sse2")))
+static void xor_sse2(const unsigned char* input, unsigned char* output, size_t length, unsigned char key) {
+    __m128i k = _mm_set1_epi8((char)key);
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(input + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(input + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(input + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(input + i + 48));
+        _mm_storeu_si128((__m128i*)(output + i), _mm_xor_si128(a, k));
+        _mm_storeu_si128((__m128i*)(output + i + 16), _mm_xor_si128(b, k));
+        _mm_storeu_si128((__m128i*)(output + i + 32), _mm_xor_si128(c, k));
+        _mm_storeu_si128((__m128i*)(output + i + 48), _mm_xor_si128(d, k));
+    }
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(input + i));
+        _mm_storeu_si128((__m128i*)(output + i), _mm_xor_si128(a, k));
+    }
+    xor_scalar(input + i, output + i, length - i, key);
+}
+
+__attribute__((target("avx2")))
+static void xor_avx2(const unsigned char* input, unsigned char* output, size_t length, unsigned char key) {
+    __m256i k = _mm256_set1_epi8((char)key);
+    size_t i = 0;
+    for (; i + 128 <= length; i += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(input + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(input + i + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(input + i + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(input + i + 96));
+        _mm256_storeu_si256((__m256i*)(output + i), _mm256_xor_si256(a, k));
+        _mm256_storeu_si256((__m256i*)(output + i + 32), _mm256_xor_si256(b, k));
+        _mm256_storeu_si256((__m256i*)(output + i + 64), _mm256_xor_si256(c, k));
+        _mm256_storeu_si256((__m256i*)(output + i + 96), _mm256_xor_si256(d, k));
+    }
+    for (; i + 32 <= length; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(input + i));
+        _mm256_storeu_si256((__m256i*)(output + i), _mm256_xor_si256(a, k));
+    }
+    xor_scalar(input + i, output + i, length - i, key);
+}
+#endif
+
+#if CRYPTO_HAVE_NEON
+static void xor_neon(const unsigned char* input, unsigned char* output, size_t length, unsigned char key) {
+    uint8x16_t k = vdupq_n_u8(key);
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        uint8x16_t a = vld1q_u8(input + i);
+        uint8x16_t b = vld1q_u8(input + i + 16);
+        uint8x16_t c = vld1q_u8(input + i + 32);
+        uint8x16_t d = vld1q_u8(input + i + 48);
+        vst1q_u8(output + i, veorq_u8(a, k));
+        vst1q_u8(output + i + 16, veorq_u8(b, k));
+        vst1q_u8(output + i + 32, veorq_u8(c, k));
+        vst1q_u8(output + i + 48, veorq_u8(d, k));
+    }
+    for (; i + 16 <= length; i += 16) {
+        vst1q_u8(output + i, veorq_u8(vld1q_u8(input + i), k));
+    }
+    xor_scalar(input + i, output + i, length - i, key);
+}
+#endif
+
 // Simple XOR encryption/decryption with single byte key
-void xor_encrypt(const unsigned char* input, unsigned char* output, int length, unsigned char key) {
-    if (!input || !output || length <= 0) {
+void xor_encrypt(const unsigned char* input, unsigned char* output, size_t length, unsigned char key) {
+    if (!input || !output || length == 0) {
         return;
     }
-    for (int i = 0; i < length; i++) {
-        output[i] = input[i] ^ key;
+    switch (crypto_simd_level()) {
+#if CRYPTO_HAVE_X86
+    case CRYPTO_SIMD_AVX2:
+        xor_avx2(input, output, length, key);
+        return;
+    case CRYPTO_SIMD_SSE2:
+        xor_sse2(input, output, length, key);
+        return;
+#endif
+#if CRYPTO_HAVE_NEON
+    case CRYPTO_SIMD_NEON:
+        xor_neon(input, output, length, key);
+        return;
+#endif
+    default:
+        xor_scalar(input, output, length, key);
+        return;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Hash
+//
+// Inputs longer than one stripe run through eight 64-bit accumulators, 64
+// bytes (one stripe) at a time: each lane adds its neighbour's word and the
+// 32x32->64 product of its own word's halves after keying. That step maps
+// directly onto SSE2/AVX2 _mm_mul_epu32 and NEON vmull_u32, so all kernels
+// produce the same value. Lanes are scrambled every 1 KB block and folded
+// with a final avalanche. Short inputs take a scalar word-at-a-time path.
+// ---------------------------------------------------------------------------
+
+#define HASH_LANES         8
+#define HASH_STRIPE        64
+#define HASH_BLOCK_STRIPES 16
+
+static const uint64_t PRIME64_1 = UINT64_C(0x9E3779B185EBCA87);
+static const uint64_t PRIME64_2 = UINT64_C(0xC2B2AE3D27D4EB4F);
+static const uint64_t PRIME64_3 = UINT64_C(0x165667B19E3779F9);
+static const uint64_t PRIME64_4 = UINT64_C(0x85EBCA77C2B2AE63);
+static const uint64_t PRIME32_1 = UINT64_C(0x9E3779B1);
+
+static const uint64_t hash_secret[HASH_LANES] = {
+    UINT64_C(0xBE4BA423396CFEB8), UINT64_C(0x1CAD21F72C81017C),
+    UINT64_C(0xDB979083E96DD4DE), UINT64_C(0x1F67B3B7A4A44072),
+    UINT64_C(0x78E5C0CC4EE679CB), UINT64_C(0x2172FFCC7DD05A82),
+    UINT64_C(0x8E2443F7744608B8), UINT64_C(0x4C263A81E69035E0),
+};
+
+typedef void (*hash_accumulate_fn)(uint64_t* acc, const unsigned char* p, size_t stripes);
+
+static inline uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t rotl64(uint64_t v, int r) {
+    return (v << r) | (v >> (64 - r));
+}
+
+static inline uint64_t avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static void accumulate_scalar(uint64_t* acc, const unsigned char* p, size_t stripes) {
+    for (size_t s = 0; s < stripes; s++, p += HASH_STRIPE) {
+        for (int i = 0; i < HASH_LANES; i++) {
+            uint64_t v = read64(p + 8 * i);
+            uint64_t k = v ^ hash_secret[i];
+            acc[i ^ 1] += v;
+            acc[i] += (k & 0xFFFFFFFFu) * (k >> 32);
+        }
+    }
+}
+
+#if CRYPTO_HAVE_X86
+__attribute__((target("sse2")))
+static void accumulate_sse2(uint64_t* acc, const unsigned char* p, size_t stripes) {
+    __m128i a[4];
+    for (int j = 0; j < 4; j++) {
+        a[j] = _mm_loadu_si128((const __m128i*)(acc + 2 * j));
+    }
+    for (size_t s = 0; s < stripes; s++, p += HASH_STRIPE) {
+        for (int j = 0; j < 4; j++) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(p + 16 * j));
+            __m128i k = _mm_xor_si128(v, _mm_loadu_si128((const __m128i*)(hash_secret + 2 * j)));
+            __m128i product = _mm_mul_epu32(k, _mm_shuffle_epi32(k, _MM_SHUFFLE(0, 3, 0, 1)));
+            a[j] = _mm_add_epi64(a[j], _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+            a[j] = _mm_add_epi64(a[j], product);
+        }
+    }
+    for (int j = 0; j < 4; j++) {
+        _mm_storeu_si128((__m128i*)(acc + 2 * j), a[j]);
+    }
+}
+
+__attribute__((target("avx2")))
+static void accumulate_avx2(uint64_t* acc, const unsigned char* p, size_t stripes) {
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+    const __m256i s0 = _mm256_loadu_si256((const __m256i*)hash_secret);
+    const __m256i s1 = _mm256_loadu_si256((const __m256i*)(hash_secret + 4));
+    for (size_t s = 0; s < stripes; s++, p += HASH_STRIPE) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+        __m256i k0 = _mm256_xor_si256(v0, s0);
+        __m256i k1 = _mm256_xor_si256(v1, s1);
+        a0 = _mm256_add_epi64(a0, _mm256_shuffle_epi32(v0, _MM_SHUFFLE(1, 0, 3, 2)));
+        a1 = _mm256_add_epi64(a1, _mm256_shuffle_epi32(v1, _MM_SHUFFLE(1, 0, 3, 2)));
+        a0 = _mm256_add_epi64(a0, _mm256_mul_epu32(k0, _mm256_shuffle_epi32(k0, _MM_SHUFFLE(0, 3, 0, 1))));
+        a1 = _mm256_add_epi64(a1, _mm256_mul_epu32(k1, _mm256_shuffle_epi32(k1, _MM_SHUFFLE(0, 3, 0, 1))));
+    }
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), a1);
+}
+#endif
+
+#if CRYPTO_HAVE_NEON
+static void accumulate_neon(uint64_t* acc, const unsigned char* p, size_t stripes) {
+    uint64x2_t a[4];
+    for (int j = 0; j < 4; j++) {
+        a[j] = vld1q_u64(acc + 2 * j);
+    }
+    for (size_t s = 0; s < stripes; s++, p += HASH_STRIPE) {
+        for (int j = 0; j < 4; j++) {
+            uint64x2_t v = vreinterpretq_u64_u8(vld1q_u8(p + 16 * j));
+            uint64x2_t k = veorq_u64(v, vld1q_u64(hash_secret + 2 * j));
+            a[j] = vaddq_u64(a[j], vextq_u64(v, v, 1));
+            a[j] = vaddq_u64(a[j], vmull_u32(vmovn_u64(k), vshrn_n_u64(k, 32)));
+        }
+    }
+    for (int j = 0; j < 4; j++) {
+        vst1q_u64(acc + 2 * j, a[j]);
+    }
+}
+#endif
+
+static hash_accumulate_fn hash_accumulator(void) {
+    switch (crypto_simd_level()) {
+#if CRYPTO_HAVE_X86
+    case CRYPTO_SIMD_AVX2:
+        return accumulate_avx2;
+    case CRYPTO_SIMD_SSE2:
+        return accumulate_sse2;
+#endif
+#if CRYPTO_HAVE_NEON
+    case CRYPTO_SIMD_NEON:
+        return accumulate_neon;
+#endif
+    default:
+        return accumulate_scalar;
+    }
+}
+
+static void scramble(uint64_t* acc) {
+    for (int i = 0; i < HASH_LANES; i++) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= hash_secret[i];
+        acc[i] = a * PRIME32_1;
+    }
+}
+
+static uint64_t hash_short(const unsigned char* p, size_t length, uint64_t seed) {
+    uint64_t h = (seed + PRIME64_4) ^ (length * PRIME64_1);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t k = rotl64(read64(p + i) * PRIME64_2, 31) * PRIME64_1;
+        h ^= k;
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (i < length) {
+        // Zero-padded tail; the length mixed in above keeps "a" and "a\0" apart
+        uint64_t tail = 0;
+        memcpy(&tail, p + i, length - i);
+        h ^= tail * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+    }
+    return avalanche(h);
+}
+
+static uint64_t hash_long(const unsigned char* p, size_t length, uint64_t seed) {
+    uint64_t acc[HASH_LANES];
+    for (int i = 0; i < HASH_LANES; i++) {
+        acc[i] = seed ^ hash_secret[(i + 4) % HASH_LANES];
+    }
+
+    hash_accumulate_fn accumulate = hash_accumulator();
+
+    // Every stripe but the last; at least one byte is left for it
+    size_t stripes = (length - 1) / HASH_STRIPE;
+    const unsigned char* cursor = p;
+    while (stripes >= HASH_BLOCK_STRIPES) {
+        accumulate(acc, cursor, HASH_BLOCK_STRIPES);
+        scramble(acc);
+        cursor += HASH_BLOCK_STRIPES * HASH_STRIPE;
+        stripes -= HASH_BLOCK_STRIPES;
+    }
+    accumulate(acc, cursor, stripes);
+
+    // The final stripe always ends at the last byte, overlapping if needed
+    accumulate(acc, p + length - HASH_STRIPE, 1);
+
+    uint64_t h = (seed + PRIME64_4) ^ (length * PRIME64_1);
+    for (int i = 0; i < HASH_LANES; i++) {
+        h = rotl64(h ^ avalanche(acc[i]), 27) * PRIME64_1 + PRIME64_4;
+    }
+    return avalanche(h);
+}
+
+uint64_t hash_bytes(const void* data, size_t length, uint64_t seed) {
+    const unsigned char* p = (const unsigned char*)data;
+    if (length <= HASH_STRIPE) {
+        return hash_short(p, length, seed);
+    }
+    return hash_long(p, length, seed);
+}
+
+// ---------------------------------------------------------------------------
+// Batches
+// ---------------------------------------------------------------------------
+
+void hash_bytes_batch(const unsigned char* data, const size_t* lengths, size_t count,
+                      uint64_t seed, uint64_t* hashes) {
+    if (!lengths || !hashes) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        hashes[i] = hash_bytes(data, lengths[i], seed);
+        data += lengths[i];
     }
 }
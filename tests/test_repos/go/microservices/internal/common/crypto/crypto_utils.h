@@ -0,0 +1,45 @@
+#ifndef CRYPTO_UTILS_H
+#define CRYPTO_UTILS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Kernel families picked at runtime from the CPU's features
+#define CRYPTO_SIMD_SCALAR 0
+#define CRYPTO_SIMD_SSE2   1
+#define CRYPTO_SIMD_AVX2   2
+#define CRYPTO_SIMD_NEON   3
+
+// Sum of all bytes of a NUL-terminated string; kept for existing callers,
+// prefer hash_bytes
+int simple_hash(const char* input);
+
+// XOR every byte with key. input and output may be the same buffer.
+void xor_encrypt(const unsigned char* input, unsigned char* output, size_t length, unsigned char key);
+
+// 64-bit non-cryptographic hash of length bytes, well distributed and equal
+// on every kernel family. Not suitable for anything security related.
+uint64_t hash_bytes(const void* data, size_t length, uint64_t seed);
+
+// Hash count inputs laid end to end in data, lengths[i] bytes each, in one
+// call (and one cgo transition); hashes[i] receives hash_bytes of input i.
+// The packed layout holds no pointers, so cgo can pass Go memory as is.
+void hash_bytes_batch(const unsigned char* data, const size_t* lengths, size_t count,
+                      uint64_t seed, uint64_t* hashes);
+
+// Currently selected kernel family
+int crypto_simd_level(void);
+
+// Force a kernel family, e.g. to compare kernels in tests or benchmarks.
+// Returns -1 (and changes nothing) if the CPU cannot run it.
+int crypto_set_simd_level(int level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRYPTO_UTILS_H
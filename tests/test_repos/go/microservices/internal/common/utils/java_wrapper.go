@@ -5,7 +5,7 @@ package utils
 #cgo LDFLAGS: -ljvm
 #cgo linux LDFLAGS: -L/usr/lib/jvm/default-java/lib/server
 #cgo darwin LDFLAGS: -L/System/Library/Frameworks/JavaVM.framework/Libraries
-#cgo windows LDFLAGS: -L"C:/Program Files/Java/jdk*/lib/server"
+#cgo windows LDFLAGS: -L"C:/Program Files/Java/jdk/lib/server"
 
 #include "jni_wrapper.h"
 #include <stdlib.h>
@@ -43,7 +43,8 @@ func CleanupJava() {
 	}
 }
 
-// FormatText formats text using Java TextUtils.formatText()
+// FormatText formats text using Java TextUtils.formatText(). It is safe to
+// call from many goroutines; each OS thread attaches its own JNIEnv.
 func FormatText(input string) (string, error) {
 	if !jvmInitialized {
 		return "", &JavaError{Message: "JVM not initialized. Call InitJava first"}
@@ -61,6 +62,35 @@ func FormatText(input string) (string, error) {
 	return C.GoString(cResult), nil
 }
 
+// FormatTextInto formats text into buf, growing it only when the result does
+// not fit, and returns the filled slice. Reusing the returned slice across
+// calls avoids the per-call C allocation and copy of FormatText.
+func FormatTextInto(input string, buf []byte) ([]byte, error) {
+	if !jvmInitialized {
+		return buf[:0], &JavaError{Message: "JVM not initialized. Call InitJava first"}
+	}
+
+	cInput := C.CString(input)
+	defer C.free(unsafe.Pointer(cInput))
+
+	for {
+		buf = buf[:cap(buf)]
+		var out *C.char
+		if len(buf) > 0 {
+			out = (*C.char)(unsafe.Pointer(&buf[0]))
+		}
+
+		n := int(C.format_text_jni_into(cInput, out, C.size_t(len(buf))))
+		if n < 0 {
+			return buf[:0], &JavaError{Message: "Failed to format text"}
+		}
+		if n < len(buf) {
+			return buf[:n], nil
+		}
+		buf = make([]byte, n+1)
+	}
+}
+
 // JavaError represents an error from Java operations
 type JavaError struct {
 	Message string
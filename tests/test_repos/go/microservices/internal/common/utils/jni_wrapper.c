@@ -1,10 +1,86 @@
 #include <jni.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "jni_wrapper.h"
 
 static JavaVM* jvm = NULL;
-static JNIEnv* env = NULL;
+
+// Each OS thread that calls in gets its own JNIEnv. Threads we attached are
+// detached by the key destructor when they exit. That includes the thread
+// that created the VM: init_jvm re-attaches it as a daemon, because Go
+// moves goroutines between OS threads and cleanup_jvm rarely runs there.
+static pthread_once_t env_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t env_key;
+static _Thread_local JNIEnv* thread_env = NULL;
+static _Thread_local JavaVM* thread_env_vm = NULL;
+
+static void detach_thread(void* vm) {
+    if ((JavaVM*)vm == jvm && jvm != NULL) {
+        (*jvm)->DetachCurrentThread(jvm);
+    }
+}
+
+static void create_env_key(void) {
+    pthread_key_create(&env_key, detach_thread);
+}
+
+// JNIEnv for the calling thread, attaching it on first use; NULL on failure
+static JNIEnv* get_env(void) {
+    if (jvm == NULL) {
+        return NULL;
+    }
+    if (thread_env != NULL && thread_env_vm == jvm) {
+        return thread_env;
+    }
+
+    JNIEnv* env = NULL;
+    jint result = (*jvm)->GetEnv(jvm, (void**)&env, JNI_VERSION_1_8);
+    if (result == JNI_EDETACHED) {
+        // Daemon, so DestroyJavaVM never waits on Go's long-lived threads
+        if ((*jvm)->AttachCurrentThreadAsDaemon(jvm, (void**)&env, NULL) != JNI_OK) {
+            return NULL;
+        }
+        pthread_once(&env_key_once, create_env_key);
+        pthread_setspecific(env_key, jvm);
+    } else if (result != JNI_OK) {
+        return NULL;
+    }
+
+    thread_env = env;
+    thread_env_vm = jvm;
+    return env;
+}
+
+// Resolved once in init_jvm: a global ref keeps the class (and with it the
+// method ID) valid across calls, so requests skip FindClass entirely
+static jclass text_utils_class = NULL;
+static jmethodID format_text_method = NULL;
+
+static int resolve_text_utils(JNIEnv* env) {
+    jclass local = (*env)->FindClass(env, "com/greenfuze/microservices/utils/TextUtils");
+    if (local == NULL) {
+        (*env)->ExceptionClear(env);
+        return -1;
+    }
+
+    format_text_method = (*env)->GetStaticMethodID(
+        env,
+        local,
+        "formatText",
+        "(Ljava/lang/String;)Ljava/lang/String;"
+    );
+    if (format_text_method == NULL) {
+        (*env)->ExceptionClear(env);
+        (*env)->DeleteLocalRef(env, local);
+        return -1;
+    }
+
+    text_utils_class = (jclass)(*env)->NewGlobalRef(env, local);
+    (*env)->DeleteLocalRef(env, local);
+    return text_utils_class != NULL ? 0 : -1;
+}
 
 int init_jvm(const char* classpath) {
     if (jvm != NULL) {
@@ -22,8 +98,25 @@ int init_jvm(const char* classpath) {
     vm_args.nOptions = 1;
     vm_args.ignoreUnrecognized = JNI_TRUE;
 
+    JNIEnv* env = NULL;
     jint result = JNI_CreateJavaVM(&jvm, (void**)&env, &vm_args);
     if (result != JNI_OK) {
+        jvm = NULL;
+        return -1;
+    }
+
+    if (resolve_text_utils(env) != 0) {
+        cleanup_jvm();
+        return -1;
+    }
+
+    // JNI_CreateJavaVM attached this thread as non-daemon, which would make
+    // DestroyJavaVM on any other thread wait for it forever
+    (*jvm)->DetachCurrentThread(jvm);
+    thread_env = NULL;
+    thread_env_vm = NULL;
+    if (get_env() == NULL) {
+        cleanup_jvm();
         return -1;
     }
 
@@ -32,64 +125,88 @@ int init_jvm(const char* classpath) {
 
 void cleanup_jvm(void) {
     if (jvm != NULL) {
-        (*jvm)->DestroyJavaVM(jvm);
+        JNIEnv* env = get_env();
+        if (env != NULL && text_utils_class != NULL) {
+            (*env)->DeleteGlobalRef(env, text_utils_class);
+        }
+        text_utils_class = NULL;
+        format_text_method = NULL;
+
+        JavaVM* vm = jvm;
         jvm = NULL;
-        env = NULL;
+        thread_env = NULL;
+        thread_env_vm = NULL;
+        (*vm)->DestroyJavaVM(vm);
     }
 }
 
-char* format_text_jni(const char* input) {
-    if (jvm == NULL || env == NULL) {
-        return NULL;
-    }
-
-    // Find the TextUtils class
-    jclass textUtilsClass = (*env)->FindClass(env, "com/greenfuze/microservices/utils/TextUtils");
-    if (textUtilsClass == NULL) {
-        return NULL;
-    }
-
-    // Find the formatText static method
-    jmethodID formatMethod = (*env)->GetStaticMethodID(
-        env,
-        textUtilsClass,
-        "formatText",
-        "(Ljava/lang/String;)Ljava/lang/String;"
-    );
-    if (formatMethod == NULL) {
-        (*env)->DeleteLocalRef(env, textUtilsClass);
+// Call TextUtils.formatText; returns a local ref the caller must delete
+static jstring call_format_text(JNIEnv* env, const char* input) {
+    if (env == NULL || text_utils_class == NULL) {
         return NULL;
     }
 
     // Convert C string to Java String
     jstring jInput = (*env)->NewStringUTF(env, input);
     if (jInput == NULL) {
-        (*env)->DeleteLocalRef(env, textUtilsClass);
+        (*env)->ExceptionClear(env);
         return NULL;
     }
 
     // Call the Java method
     jstring jResult = (jstring)(*env)->CallStaticObjectMethod(
         env,
-        textUtilsClass,
-        formatMethod,
+        text_utils_class,
+        format_text_method,
         jInput
     );
+    (*env)->DeleteLocalRef(env, jInput);
 
-    // Convert Java String back to C string
-    char* result = NULL;
-    if (jResult != NULL) {
-        const char* utfResult = (*env)->GetStringUTFChars(env, jResult, NULL);
-        if (utfResult != NULL) {
-            result = strdup(utfResult);
-            (*env)->ReleaseStringUTFChars(env, jResult, utfResult);
+    if ((*env)->ExceptionCheck(env)) {
+        (*env)->ExceptionClear(env);
+        if (jResult != NULL) {
+            (*env)->DeleteLocalRef(env, jResult);
         }
-        (*env)->DeleteLocalRef(env, jResult);
+        return NULL;
     }
+    return jResult;
+}
 
-    // Cleanup
-    (*env)->DeleteLocalRef(env, jInput);
-    (*env)->DeleteLocalRef(env, textUtilsClass);
+char* format_text_jni(const char* input) {
+    JNIEnv* env = get_env();
+    jstring jResult = call_format_text(env, input);
+    if (jResult == NULL) {
+        return NULL;
+    }
+
+    // Copy the modified UTF-8 straight into the result, no intermediate
+    // GetStringUTFChars buffer
+    jsize length = (*env)->GetStringUTFLength(env, jResult);
+    char* result = malloc((size_t)length + 1);
+    if (result != NULL) {
+        (*env)->GetStringUTFRegion(env, jResult, 0, (*env)->GetStringLength(env, jResult), result);
+        result[length] = '\0';
+    }
 
+    (*env)->DeleteLocalRef(env, jResult);
     return result;
 }
+
+int format_text_jni_into(const char* input, char* output, size_t output_size) {
+    JNIEnv* env = get_env();
+    jstring jResult = call_format_text(env, input);
+    if (jResult == NULL) {
+        return -1;
+    }
+
+    jsize length = (*env)->GetStringUTFLength(env, jResult);
+    if ((size_t)length < output_size) {
+        (*env)->GetStringUTFRegion(env, jResult, 0, (*env)->GetStringLength(env, jResult), output);
+        output[length] = '\0';
+    } else if (output_size > 0) {
+        output[0] = '\0';
+    }
+
+    (*env)->DeleteLocalRef(env, jResult);
+    return (int)length;
+}
@@ -1,6 +1,8 @@
 #ifndef JNI_WRAPPER_H
 #define JNI_WRAPPER_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -15,6 +17,12 @@ void cleanup_jvm(void);
 // Returns a newly allocated string that must be freed by caller
 char* format_text_jni(const char* input);
 
+// Format text into a caller-owned buffer, avoiding the per-call allocation.
+// Returns the result length in bytes (excluding the terminator), or -1 on
+// failure. If the length is >= output_size nothing is copied; retry with a
+// buffer of at least length + 1 bytes.
+int format_text_jni_into(const char* input, char* output, size_t output_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime under strict C11
+
+#include "core/memory.h"
+#include "protocol/handler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Decodes a batch of encoded Events held in one pool buffer, once with the
+// generated zero-copy decoder and once with a copy-out decoder that gives
+// every string/bytes field its own heap allocation, as owning decoders do.
+#define BATCH 64
+#define ROUNDS 2000
+
+static const size_t payload_sizes[] = {16, 64, 256, 1024, 4096};
+#define PAYLOAD_SIZE_COUNT (sizeof(payload_sizes) / sizeof(payload_sizes[0]))
+
+typedef struct {
+    uint32_t event_id;
+    char* event_type;
+    int64_t timestamp;
+    uint8_t* data;
+    size_t data_size;
+} owned_event_t;
+
+static int decode_copy_out(owned_event_t* out, const uint8_t* buffer, size_t length) {
+    proto_event_t view;
+    if (proto_event_decode(&view, buffer, length) != 0) {
+        return -1;
+    }
+
+    out->event_id = view.event_id;
+    out->timestamp = view.timestamp;
+    out->event_type = malloc(view.event_type.size + 1);
+    out->data = malloc(view.data.size);
+    if (out->event_type == NULL || out->data == NULL) {
+        free(out->event_type);
+        free(out->data);
+        return -1;
+    }
+    memcpy(out->event_type, view.event_type.data, view.event_type.size);
+    out->event_type[view.event_type.size] = '\0';
+    memcpy(out->data, view.data.data, view.data.size);
+    out->data_size = view.data.size;
+    return 0;
+}
+
+static double elapsed_seconds(const struct timespec* start, const struct timespec* end) {
+    return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(void) {
+    memory_init();
+
+    printf("%8s %10s %16s %12s %16s %12s\n",
+           "payload", "frame", "view msgs/sec", "view MB/s", "copy msgs/sec", "copy MB/s");
+
+    int status = 0;
+    for (size_t s = 0; s < PAYLOAD_SIZE_COUNT; s++) {
+        uint8_t* payload = malloc(payload_sizes[s]);
+        memset(payload, 0x5A, payload_sizes[s]);
+
+        proto_event_t event = {0};
+        event.event_type.data = (const uint8_t*)"sensor.sample";
+        event.event_type.size = 13;
+        event.data.data = payload;
+        event.data.size = payload_sizes[s];
+
+        // Encode the batch back-to-back into one pool buffer
+        event.event_id = BATCH;
+        event.timestamp = 1700000000000LL + BATCH;
+        size_t frame_size = proto_event_encoded_size(&event);
+        uint8_t* wire = memory_alloc(frame_size * BATCH);
+        if (wire == NULL) {
+            return 1;
+        }
+
+        size_t offsets[BATCH + 1] = {0};
+        for (int i = 0; i < BATCH; i++) {
+            event.event_id = (uint32_t)i + 1;
+            event.timestamp = 1700000000000LL + i;
+            int written = proto_event_encode(&event, wire + offsets[i], frame_size);
+            if (written < 0) {
+                return 1;
+            }
+            offsets[i + 1] = offsets[i] + (size_t)written;
+        }
+        size_t batch_bytes = offsets[BATCH];
+
+        uint64_t checksum = 0;
+        struct timespec start, end;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < ROUNDS; r++) {
+            for (int i = 0; i < BATCH; i++) {
+                proto_event_t decoded;
+                if (proto_event_decode(&decoded, wire + offsets[i], offsets[i + 1] - offsets[i]) != 0) {
+                    status = 1;
+                    continue;
+                }
+                checksum += decoded.event_id + decoded.data.data[decoded.data.size - 1];
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double view_seconds = elapsed_seconds(&start, &end);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < ROUNDS; r++) {
+            for (int i = 0; i < BATCH; i++) {
+                owned_event_t decoded;
+                if (decode_copy_out(&decoded, wire + offsets[i], offsets[i + 1] - offsets[i]) != 0) {
+                    status = 1;
+                    continue;
+                }
+                checksum += decoded.event_id + decoded.data[decoded.data_size - 1];
+                free(decoded.event_type);
+                free(decoded.data);
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double copy_seconds = elapsed_seconds(&start, &end);
+
+        double messages = (double)BATCH * ROUNDS;
+        double bytes = (double)batch_bytes * ROUNDS;
+        printf("%8zu %10zu %16.0f %12.1f %16.0f %12.1f\n",
+               payload_sizes[s], batch_bytes / BATCH,
+               messages / view_seconds, bytes / view_seconds / 1e6,
+               messages / copy_seconds, bytes / copy_seconds / 1e6);
+
+        // Keep the decode loops from being optimized away
+        if (checksum == 0) {
+            status = 1;
+        }
+        memory_free(wire);
+        free(payload);
+    }
+
+    memory_cleanup();
+    return status;
+}
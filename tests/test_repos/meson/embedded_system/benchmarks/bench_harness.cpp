@@ -0,0 +1,180 @@
+#include "bench_harness.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+extern "C" {
+    #include "core/memory.h"
+    #include "core/system.h"
+}
+
+// Every heap allocation in the benchmark binary goes through here
+namespace {
+std::atomic<uint64_t> heap_allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace bench {
+
+namespace {
+
+double percentile(const std::vector<double>& sorted, double p) {
+    size_t idx = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+void write_json_string(FILE* out, const std::string& s) {
+    std::fputc('"', out);
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', out);
+        }
+        std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+void write_json(FILE* out, const std::vector<Result>& results) {
+    std::fprintf(out, "{\n  \"project\": \"%s\",\n  \"version\": \"%s\",\n", PROJECT_NAME, VERSION);
+    std::fprintf(out, "  \"build_type\": \"%s\",\n  \"platform\": \"%s\",\n", BUILD_TYPE, PLATFORM);
+    std::fprintf(out, "  \"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        std::fprintf(out, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+        write_json_string(out, r.name);
+        std::fprintf(out,
+                     ", \"batch_ops\": %zu, \"samples\": %zu, \"ns_per_op\": %.3f, "
+                     "\"min_ns\": %.3f, \"p50_ns\": %.3f, \"p90_ns\": %.3f, \"p99_ns\": %.3f, "
+                     "\"max_ns\": %.3f, \"allocs_per_op\": %.4f, \"heap_allocs_per_op\": %.4f, "
+                     "\"pool_allocs_per_op\": %.4f}",
+                     r.batch_ops, r.samples, r.ns_per_op, r.min_ns, r.p50_ns, r.p90_ns, r.p99_ns,
+                     r.max_ns, r.heap_allocs_per_op + r.pool_allocs_per_op,
+                     r.heap_allocs_per_op, r.pool_allocs_per_op);
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+}
+
+} // namespace
+
+AllocCounters alloc_counters() {
+    memory_stats_t stats;
+    memory_get_stats(&stats);
+    return {heap_allocations.load(std::memory_order_relaxed), stats.allocs};
+}
+
+Suite::Suite(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0;
+        if (std::strcmp(arg, "--json") == 0) {
+            json_ = true;
+            if (has_value) {
+                json_path_ = argv[++i];
+            }
+        } else if (std::strcmp(arg, "--filter") == 0 && has_value) {
+            filter_ = argv[++i];
+        } else if (std::strcmp(arg, "--samples") == 0 && has_value) {
+            samples_ = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(arg, "--min-batch-us") == 0 && has_value) {
+            min_batch_ns_ = 1000.0 * std::strtod(argv[++i], nullptr);
+        } else {
+            std::fprintf(stderr, "unknown argument: %s\n", arg);
+            bad_args_ = true;
+        }
+    }
+}
+
+bool Suite::selected(const std::string& name) const {
+    return !bad_args_ && (filter_.empty() || name.find(filter_) != std::string::npos);
+}
+
+void Suite::record(const std::string& name, size_t batch, std::vector<double>& per_op,
+                   const AllocCounters& before, const AllocCounters& after) {
+    double total = 0.0;
+    for (double ns : per_op) {
+        total += ns;
+    }
+    std::sort(per_op.begin(), per_op.end());
+
+    double ops = static_cast<double>(batch) * static_cast<double>(per_op.size());
+    Result r;
+    r.name = name;
+    r.batch_ops = batch;
+    r.samples = per_op.size();
+    r.ns_per_op = total / static_cast<double>(per_op.size());
+    r.min_ns = per_op.front();
+    r.p50_ns = percentile(per_op, 0.50);
+    r.p90_ns = percentile(per_op, 0.90);
+    r.p99_ns = percentile(per_op, 0.99);
+    r.max_ns = per_op.back();
+    r.heap_allocs_per_op = static_cast<double>(after.heap - before.heap) / ops;
+    r.pool_allocs_per_op = static_cast<double>(after.pool - before.pool) / ops;
+    results_.push_back(r);
+
+    // Progress goes to stderr so `--json` on stdout stays parseable
+    if (json_ && json_path_.empty()) {
+        std::fprintf(stderr, "%s done\n", name.c_str());
+    }
+}
+
+int Suite::finish() {
+    if (bad_args_) {
+        return 2;
+    }
+
+    if (!json_ || !json_path_.empty()) {
+        std::printf("%-32s %9s %10s %10s %10s %10s %10s\n",
+                    "benchmark", "batch", "ns/op", "p50", "p90", "p99", "allocs/op");
+        for (const Result& r : results_) {
+            std::printf("%-32s %9zu %10.1f %10.1f %10.1f %10.1f %10.3f\n",
+                        r.name.c_str(), r.batch_ops, r.ns_per_op, r.p50_ns, r.p90_ns, r.p99_ns,
+                        r.heap_allocs_per_op + r.pool_allocs_per_op);
+        }
+    }
+
+    if (json_) {
+        FILE* out = json_path_.empty() ? stdout : std::fopen(json_path_.c_str(), "w");
+        if (out == nullptr) {
+            std::fprintf(stderr, "cannot write %s\n", json_path_.c_str());
+            return 1;
+        }
+        write_json(out, results_);
+        if (out != stdout) {
+            std::fclose(out);
+            std::printf("\nResults written to %s\n", json_path_.c_str());
+        }
+    }
+    return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,113 @@
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark harness for the hot-path suite.
+//
+// Each benchmark is timed in batches: the batch size doubles until one
+// batch takes long enough for the clock to be negligible, then a fixed
+// number of batches are sampled. ns/op and the percentiles are taken over
+// the per-batch averages, so p99 means "the slowest 1% of batches", not
+// single-call latency. Allocations are counted over the sampled batches:
+// heap allocations through operator new, pool allocations through the
+// memory module's counters.
+
+namespace bench {
+
+// Keep `value` (and whatever produced it) from being optimized away
+template <typename T>
+inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+struct Result {
+    std::string name;
+    size_t batch_ops;
+    size_t samples;
+    double ns_per_op;
+    double min_ns;
+    double p50_ns;
+    double p90_ns;
+    double p99_ns;
+    double max_ns;
+    double heap_allocs_per_op;
+    double pool_allocs_per_op;
+};
+
+struct AllocCounters {
+    uint64_t heap;
+    uint64_t pool;
+};
+
+AllocCounters alloc_counters();
+
+class Suite {
+public:
+    // Options: --json [path] (stdout when no path), --filter <substring>,
+    // --samples <n>, --min-batch-us <n>
+    Suite(int argc, char** argv);
+
+    // Time op(i) for increasing i; op should feed its result to keep()
+    template <typename Op>
+    void run(const std::string& name, Op&& op) {
+        if (!selected(name)) {
+            return;
+        }
+
+        size_t batch = 1;
+        while (time_batch(op, batch) < min_batch_ns_ && batch < kMaxBatch) {
+            batch *= 2;
+        }
+
+        std::vector<double> per_op(samples_);
+        AllocCounters before = alloc_counters();
+        for (size_t s = 0; s < samples_; ++s) {
+            per_op[s] = time_batch(op, batch) / static_cast<double>(batch);
+        }
+        AllocCounters after = alloc_counters();
+
+        record(name, batch, per_op, before, after);
+    }
+
+    // Print the report; returns the process exit status
+    int finish();
+
+private:
+    static constexpr size_t kMaxBatch = size_t(1) << 24;
+
+    template <typename Op>
+    static double time_batch(Op& op, size_t batch) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < batch; ++i) {
+            op(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    bool selected(const std::string& name) const;
+    void record(const std::string& name, size_t batch, std::vector<double>& per_op,
+                const AllocCounters& before, const AllocCounters& after);
+
+    std::vector<Result> results_;
+    std::string filter_;
+    std::string json_path_;
+    bool json_ = false;
+    size_t samples_ = 200;
+    double min_batch_ns_ = 20000.0;
+    bool bad_args_ = false;
+};
+
+} // namespace bench
+
+#endif // BENCH_HARNESS_HPP
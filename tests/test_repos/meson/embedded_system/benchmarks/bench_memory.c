@@ -0,0 +1,88 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime under strict C11
+
+#include "core/memory.h"
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+// Each worker keeps a few blocks alive and recycles them, which is the
+// allocation pattern of the protocol workers.
+#define OPS_PER_THREAD 20000
+#define LIVE_BLOCKS 8
+#define MAX_THREADS 64
+
+static const size_t block_sizes[] = {32, 64, 128, 256};
+#define BLOCK_SIZE_COUNT (sizeof(block_sizes) / sizeof(block_sizes[0]))
+
+typedef struct {
+    int failures;
+} worker_result_t;
+
+static void* worker(void* arg) {
+    worker_result_t* result = (worker_result_t*)arg;
+    void* live[LIVE_BLOCKS] = {NULL};
+
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        int slot = i % LIVE_BLOCKS;
+        memory_free(live[slot]);
+        live[slot] = memory_alloc(block_sizes[i % BLOCK_SIZE_COUNT]);
+        if (live[slot] == NULL) {
+            result->failures++;
+        }
+    }
+
+    for (int slot = 0; slot < LIVE_BLOCKS; slot++) {
+        memory_free(live[slot]);
+    }
+    return NULL;
+}
+
+static double elapsed_seconds(const struct timespec* start, const struct timespec* end) {
+    return (double)(end->tv_sec - start->tv_sec) + (double)(end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int run(memory_mode_t mode, int threads, double* ops_per_sec) {
+    pthread_t handles[MAX_THREADS];
+    worker_result_t results[MAX_THREADS] = {{0}};
+
+    memory_set_mode(mode);
+    memory_init();
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&handles[t], NULL, worker, &results[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(handles[t], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    int failures = 0;
+    for (int t = 0; t < threads; t++) {
+        failures += results[t].failures;
+    }
+
+    // One alloc and one free per iteration
+    *ops_per_sec = 2.0 * OPS_PER_THREAD * threads / elapsed_seconds(&start, &end);
+    memory_cleanup();
+    return failures;
+}
+
+int main(void) {
+    const memory_mode_t modes[] = {MEMORY_MODE_SHARED, MEMORY_MODE_THREAD_CACHE};
+    const char* mode_names[] = {"shared", "thread-cache"};
+    int total_failures = 0;
+
+    printf("%-14s %8s %16s %10s\n", "mode", "threads", "ops/sec", "failures");
+    for (int m = 0; m < 2; m++) {
+        for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+            double ops_per_sec;
+            int failures = run(modes[m], threads, &ops_per_sec);
+            printf("%-14s %8d %16.0f %10d\n", mode_names[m], threads, ops_per_sec, failures);
+            total_failures += failures;
+        }
+    }
+
+    return total_failures == 0 ? 0 : 1;
+}
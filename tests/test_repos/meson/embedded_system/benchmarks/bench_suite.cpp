@@ -0,0 +1,185 @@
+#include "bench_harness.hpp"
+#include "drivers/spi.hpp"
+#include "drivers/spi_fixed.hpp"
+#include "drivers/uart.hpp"
+#include "drivers/uart_fixed.hpp"
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+    #include "core/memory.h"
+    #include "core/system.h"
+    #include "protocol/handler.h"
+    #include "protocol/shm_transport.h"
+}
+
+// Hot paths of the firmware libraries, one row per path and size. Run it
+// from both a release and a debug build; the JSON report records which.
+
+namespace {
+
+constexpr size_t kAllocSizes[] = {32, 256, 2048};
+constexpr size_t kTransferSizes[] = {16, 256};
+
+void bench_memory(bench::Suite& suite) {
+    for (size_t size : kAllocSizes) {
+        suite.run("memory/alloc_free/" + std::to_string(size), [size](size_t) {
+            void* block = memory_alloc(size);
+            bench::keep(block);
+            memory_free(block);
+        });
+    }
+
+    // Steady state with live blocks, as in the protocol workers
+    void* live[8] = {nullptr};
+    suite.run("memory/recycle_8_live/64", [&live](size_t i) {
+        size_t slot = i % 8;
+        memory_free(live[slot]);
+        live[slot] = memory_alloc(64);
+        bench::keep(live[slot]);
+    });
+    for (void* block : live) {
+        memory_free(block);
+    }
+}
+
+bool bench_uart(bench::Suite& suite) {
+    drivers::UART uart(921600);
+    drivers::fixed::UART<921600> fixed_uart;
+    if (!uart.init() || !fixed_uart.init()) {
+        return false;
+    }
+
+    for (size_t size : kTransferSizes) {
+        std::vector<uint8_t> data(size, 0x5A);
+        suite.run("uart/send/" + std::to_string(size), [&](size_t) {
+            bench::keep(uart.send(data.data(), data.size()));
+        });
+        suite.run("uart/send_fixed/" + std::to_string(size), [&](size_t) {
+            bench::keep(fixed_uart.send(data.data(), data.size()));
+        });
+    }
+    return true;
+}
+
+bool bench_spi(bench::Suite& suite) {
+    drivers::SPI spi(1000000, drivers::SPIMode::MODE_0);
+    drivers::fixed::SPI<1000000> fixed_spi;
+    if (!spi.init() || !fixed_spi.init()) {
+        return false;
+    }
+
+    for (size_t size : kTransferSizes) {
+        std::vector<uint8_t> tx(size, 0xA5);
+        std::vector<uint8_t> rx(size);
+        suite.run("spi/transfer_vector/" + std::to_string(size), [&](size_t) {
+            std::vector<uint8_t> result = spi.transfer(tx);
+            bench::keep(result.data());
+        });
+        suite.run("spi/transfer_buffer/" + std::to_string(size), [&](size_t) {
+            bench::keep(spi.transfer(tx.data(), rx.data(), size));
+        });
+        suite.run("spi/transfer_fixed/" + std::to_string(size), [&](size_t) {
+            bench::keep(fixed_spi.transfer(tx.data(), rx.data(), size));
+        });
+    }
+    return true;
+}
+
+bool bench_protocol(bench::Suite& suite) {
+    if (protocol_init() != 0) {
+        return false;
+    }
+
+    const char command[] = "status";
+    proto_request_t request = {};
+    request.request_id = 1;
+    request.command.data = reinterpret_cast<const uint8_t*>(command);
+    request.command.size = sizeof(command) - 1;
+
+    std::vector<uint8_t> payload(proto_request_encoded_size(&request));
+    proto_request_encode(&request, payload.data(), payload.size());
+
+    protocol_message_t msg = {};
+    msg.type = MSG_TYPE_REQUEST;
+    msg.payload = payload.data();
+    msg.payload_size = payload.size();
+
+    suite.run("protocol/handle_message/request", [&msg](size_t i) {
+        msg.id = static_cast<uint32_t>(i);
+        bench::keep(protocol_handle_message(&msg));
+    });
+
+    // Host-simulation ingress: frame into a shared-memory ring, then pump
+    // it through the handler table, one message per op
+    shm_channel_t* ring = shm_channel_create("/embedded_system_bench_shm", 0);
+    if (ring == nullptr) {
+        protocol_cleanup();
+        return false;
+    }
+    suite.run("protocol/shm_send_pump/request", [&](size_t i) {
+        msg.id = static_cast<uint32_t>(i);
+        shm_channel_send(ring, &msg, 0);
+        bench::keep(shm_channel_pump(ring, 1, 0));
+    });
+    shm_channel_close(ring);
+
+    protocol_cleanup();
+    return true;
+}
+
+bool bench_codec(bench::Suite& suite) {
+    for (size_t size : kTransferSizes) {
+        std::vector<uint8_t> data(size, 0x11);
+        const char event_type[] = "sensor.reading";
+
+        proto_event_t event = {};
+        event.event_id = 7;
+        event.event_type.data = reinterpret_cast<const uint8_t*>(event_type);
+        event.event_type.size = sizeof(event_type) - 1;
+        event.timestamp = 1700000000000LL;
+        event.data.data = data.data();
+        event.data.size = data.size();
+
+        std::vector<uint8_t> buffer(proto_event_encoded_size(&event));
+        std::string suffix = "/" + std::to_string(size);
+
+        suite.run("codec/event_encode" + suffix, [&](size_t) {
+            bench::keep(proto_event_encode(&event, buffer.data(), buffer.size()));
+        });
+
+        int encoded = proto_event_encode(&event, buffer.data(), buffer.size());
+        if (encoded < 0) {
+            return false;
+        }
+        size_t length = static_cast<size_t>(encoded);
+        suite.run("codec/event_decode" + suffix, [&](size_t) {
+            proto_event_t decoded;
+            bench::keep(proto_event_decode(&decoded, buffer.data(), length));
+            bench::keep(decoded);
+        });
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Suite suite(argc, argv);
+
+    // Brings up the memory pool too; the drivers refuse to start without it
+    if (system_init() != 0) {
+        std::fprintf(stderr, "System initialization failed\n");
+        return 1;
+    }
+
+    bench_memory(suite);
+    bool ok = bench_uart(suite) && bench_spi(suite) && bench_protocol(suite) && bench_codec(suite);
+
+    system_shutdown();
+    if (!ok) {
+        std::fprintf(stderr, "benchmark setup failed\n");
+        return 1;
+    }
+    return suite.finish();
+}
@@ -1,43 +1,91 @@
 #include "core/system.h"
 #include "core/memory.h"
+#include "core/scheduler.h"
 #include "protocol/handler.h"
+#include "protocol/shm_transport.h"
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <pthread.h>
+#include <string.h>
 
 // Forward declarations for C++ drivers (using extern "C" on their side)
 // We'll call them through a C wrapper in a real implementation
 // For this stub, we'll just reference the system
 
-static void* worker_thread(void* arg) {
-    (void)arg;
+#define MESSAGE_TASKS 64
 
-    printf("Worker thread started\n");
+static atomic_int messages_handled = 0;
 
-    // Allocate some memory
-    void* buffer = memory_alloc(256);
+// One protocol message per task; everything built for it lives in the
+// worker's task arena, which the scheduler resets between tasks
+static void message_task(void* arg, memory_arena_t* arena) {
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+
+    const char command[] = "status";
+    proto_request_t request = {0};
+    request.request_id = id;
+    request.command.data = (const uint8_t*)command;
+    request.command.size = sizeof(command) - 1;
+
+    size_t size = proto_request_encoded_size(&request);
+    uint8_t* buffer = memory_arena_alloc(arena, size);
     if (buffer == NULL) {
         printf("Failed to allocate memory\n");
-        return NULL;
+        return;
     }
+    proto_request_encode(&request, buffer, size);
 
-    // Send a test protocol message
     protocol_message_t msg = {
         .type = MSG_TYPE_REQUEST,
-        .id = 1,
-        .payload = (uint8_t*)buffer,
-        .payload_size = 256
+        .id = id,
+        .payload = buffer,
+        .payload_size = size
     };
 
+    if (protocol_handle_message(&msg) == 0) {
+        atomic_fetch_add(&messages_handled, 1);
+    }
     protocol_send_message(&msg);
+}
+
+#ifdef ENABLE_DEBUG
+// Per-tracepoint latency summary; only points that fired are listed
+static void print_metrics(void) {
+    system_metrics_t metrics;
+    if (system_get_metrics(&metrics) != 0) {
+        return;
+    }
 
-    printf("Worker thread finished\n");
-    return NULL;
+    printf("Trace events: %llu (%llu overwritten)\n",
+           (unsigned long long)metrics.trace_events,
+           (unsigned long long)metrics.trace_overwritten);
+    for (int i = 0; i < TRACE_POINT_COUNT; i++) {
+        const trace_latency_t* l = &metrics.latency[i];
+        if (l->count == 0) {
+            continue;
+        }
+        printf("  %-18s count=%-6llu p50=%lluns p99=%lluns max=%lluns\n",
+               trace_point_name((trace_point_t)i), (unsigned long long)l->count,
+               (unsigned long long)l->p50_ns, (unsigned long long)l->p99_ns,
+               (unsigned long long)l->max_ns);
+    }
 }
+#endif
 
 int main(int argc, char** argv) {
-    (void)argc;
-    (void)argv;
+    // --trace <path>: write a Chrome trace of the run (debug builds only)
+    // --shm <name>: send outbound frames into a shared-memory channel that
+    //               host tools can map, instead of simulating the send
+    const char* trace_path = NULL;
+    const char* shm_name = NULL;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--trace") == 0) {
+            trace_path = argv[i + 1];
+        } else if (strcmp(argv[i], "--shm") == 0) {
+            shm_name = argv[i + 1];
+        }
+    }
 
     printf("=== Embedded System Firmware ===\n");
     printf("Version: %s\n", VERSION);
@@ -56,20 +104,70 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    // Create worker thread
-    pthread_t thread;
-    if (pthread_create(&thread, NULL, worker_thread, NULL) != 0) {
-        fprintf(stderr, "Failed to create worker thread\n");
+    shm_channel_t* shm = NULL;
+    if (shm_name != NULL) {
+        shm = shm_channel_create(shm_name, 0);
+        if (shm == NULL) {
+            fprintf(stderr, "Failed to create shared-memory channel %s\n", shm_name);
+            protocol_cleanup();
+            system_shutdown();
+            return 1;
+        }
+        protocol_set_transport(shm_transport_write, shm);
+    }
+
+    // Batch outbound traffic on a sender thread; protocol_cleanup() flushes it
+    if (protocol_queue_start(NULL) != 0) {
+        fprintf(stderr, "Outbound queue start failed\n");
         protocol_cleanup();
+        shm_channel_close(shm);
         system_shutdown();
         return 1;
     }
 
-    // Wait for worker thread
-    pthread_join(thread, NULL);
+    // Spread protocol handling over one worker per core
+    if (scheduler_start(NULL) != 0) {
+        fprintf(stderr, "Failed to start worker pool\n");
+        protocol_cleanup();
+        shm_channel_close(shm);
+        system_shutdown();
+        return 1;
+    }
+
+    for (uintptr_t i = 0; i < MESSAGE_TASKS; i++) {
+        if (scheduler_submit(message_task, (void*)(i + 1)) != 0) {
+            fprintf(stderr, "Failed to submit message task\n");
+        }
+    }
+    scheduler_wait();
+    printf("Handled %d messages on %zu workers\n",
+           atomic_load(&messages_handled), scheduler_thread_count());
+    scheduler_stop();
 
     // Cleanup
     protocol_cleanup();
+    if (shm != NULL) {
+        protocol_set_transport(NULL, NULL);
+        shm_channel_close(shm);
+    }
+
+#ifdef ENABLE_DEBUG
+    // All traced threads are idle now
+    print_metrics();
+    if (trace_path != NULL) {
+        long events = trace_export_chrome(trace_path);
+        if (events < 0) {
+            fprintf(stderr, "Failed to write trace to %s\n", trace_path);
+        } else {
+            printf("Wrote %ld trace events to %s\n", events, trace_path);
+        }
+    }
+#else
+    if (trace_path != NULL) {
+        fprintf(stderr, "Tracing is only available in debug builds\n");
+    }
+#endif
+
     system_shutdown();
 
     printf("Firmware exited successfully\n");
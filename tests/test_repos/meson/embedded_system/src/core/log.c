@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "log.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+
+#define LOG_DRAIN_INTERVAL_NS (5 * 1000 * 1000)
+
+_Static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+
+// Bounded MPSC ring: each slot carries a sequence number that tells
+// producers when it is free and the consumer when it is filled
+typedef struct {
+    atomic_size_t seq;
+    log_level_t level;
+    char text[LOG_MESSAGE_MAX];
+} log_slot_t;
+
+static log_slot_t ring[LOG_RING_SIZE];
+static _Alignas(64) atomic_size_t write_pos = 0;
+static _Alignas(64) size_t read_pos = 0;
+static atomic_size_t dropped = 0;
+static atomic_bool ring_ready = false;
+static pthread_once_t ring_once = PTHREAD_ONCE_INIT;
+
+// The consumer side is single-threaded; the lock only arbitrates between
+// the drain thread and explicit log_flush() callers, never producers
+static pthread_mutex_t drain_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t thread_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t drain_thread;
+static atomic_bool draining = false;
+
+static void ring_init(void) {
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) {
+        atomic_store_explicit(&ring[i].seq, i, memory_order_relaxed);
+    }
+    atomic_store_explicit(&ring_ready, true, memory_order_release);
+}
+
+void log_write(log_level_t level, const char* fmt, ...) {
+    if (!atomic_load_explicit(&ring_ready, memory_order_acquire)) {
+        pthread_once(&ring_once, ring_init);
+    }
+
+    size_t pos = atomic_load_explicit(&write_pos, memory_order_relaxed);
+    log_slot_t* slot;
+    for (;;) {
+        slot = &ring[pos & (LOG_RING_SIZE - 1)];
+        size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == pos) {
+            if (atomic_compare_exchange_weak_explicit(&write_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (seq < pos) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&write_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(slot->text, sizeof(slot->text), fmt, args);
+    va_end(args);
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+size_t log_flush(void) {
+    if (!atomic_load_explicit(&ring_ready, memory_order_acquire)) {
+        return 0;
+    }
+
+    size_t written = 0;
+    bool to_stderr = false;
+    pthread_mutex_lock(&drain_lock);
+    for (;;) {
+        log_slot_t* slot = &ring[read_pos & (LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != read_pos + 1) {
+            break;
+        }
+
+        FILE* out = slot->level <= LOG_LEVEL_WARN ? stderr : stdout;
+        to_stderr |= out == stderr;
+        fputs(slot->text, out);
+        fputc('\n', out);
+
+        atomic_store_explicit(&slot->seq, read_pos + LOG_RING_SIZE, memory_order_release);
+        read_pos++;
+        written++;
+    }
+    pthread_mutex_unlock(&drain_lock);
+
+    // One flush per batch rather than one per line
+    if (written > 0) {
+        fflush(stdout);
+        if (to_stderr) {
+            fflush(stderr);
+        }
+    }
+    return written;
+}
+
+static void* drain_main(void* arg) {
+    (void)arg;
+    const struct timespec interval = {0, LOG_DRAIN_INTERVAL_NS};
+    while (atomic_load_explicit(&draining, memory_order_acquire)) {
+        log_flush();
+        nanosleep(&interval, NULL);
+    }
+    return NULL;
+}
+
+int log_start(void) {
+    pthread_once(&ring_once, ring_init);
+
+    int result = 0;
+    pthread_mutex_lock(&thread_lock);
+    if (!atomic_load_explicit(&draining, memory_order_relaxed)) {
+        atomic_store_explicit(&draining, true, memory_order_release);
+        if (pthread_create(&drain_thread, NULL, drain_main, NULL) != 0) {
+            atomic_store_explicit(&draining, false, memory_order_relaxed);
+            result = -1;
+        }
+    }
+    pthread_mutex_unlock(&thread_lock);
+    return result;
+}
+
+void log_stop(void) {
+    pthread_mutex_lock(&thread_lock);
+    if (atomic_load_explicit(&draining, memory_order_relaxed)) {
+        atomic_store_explicit(&draining, false, memory_order_release);
+        pthread_join(drain_thread, NULL);
+    }
+    pthread_mutex_unlock(&thread_lock);
+    log_flush();
+}
+
+size_t log_dropped(void) {
+    return atomic_load_explicit(&dropped, memory_order_relaxed);
+}
@@ -0,0 +1,59 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include "config.h"
+#include <stddef.h>
+
+// Log levels, most severe first
+typedef enum {
+    LOG_LEVEL_ERROR = 0,
+    LOG_LEVEL_WARN = 1,
+    LOG_LEVEL_INFO = 2,
+    LOG_LEVEL_DEBUG = 3
+} log_level_t;
+
+// Highest level compiled in. Anything above it is dead code the compiler
+// drops, arguments and all, while the format string is still type-checked.
+#ifndef LOG_LEVEL_MAX
+#ifdef ENABLE_DEBUG_LOGS
+#define LOG_LEVEL_MAX LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL_MAX LOG_LEVEL_WARN
+#endif
+#endif
+
+#define LOG_RING_SIZE 256
+#define LOG_MESSAGE_MAX 128
+
+#define LOG_AT(level, ...) \
+    do { \
+        if ((level) <= LOG_LEVEL_MAX) { \
+            log_write((level), __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+// Format a message into the lock-free ring; never blocks or flushes.
+// Messages are truncated to LOG_MESSAGE_MAX and dropped when the ring is full.
+void log_write(log_level_t level, const char* fmt, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+// Start / stop the background thread that drains the ring to stdout/stderr.
+// Both are idempotent; log_stop() drains whatever is left.
+int log_start(void);
+void log_stop(void);
+
+// Drain the ring on the calling thread; returns the number of messages written
+size_t log_flush(void);
+
+// Messages lost to a full ring since startup
+size_t log_dropped(void);
+
+#endif // LOG_H
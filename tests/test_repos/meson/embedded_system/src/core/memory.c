@@ -1,49 +1,747 @@
 #include "memory.h"
+#include "config.h"
+#include "log.h"
+#include "trace.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
-#define MEMORY_POOL_SIZE (1024 * 1024)  // 1 MB
+#define MEMORY_POOL_SIZE ((size_t)1024 * 1024)  // 1 MB
 
-static uint8_t memory_pool[MEMORY_POOL_SIZE];
-static size_t memory_used = 0;
+// Block layout: every block starts with a one-word header holding the block
+// size (a multiple of ALIGNMENT) and three flag bits. Free large blocks also
+// keep a copy of the header in their last word (boundary tag) so that the
+// following block can find and coalesce with them on free.
+#define ALIGNMENT       8
+#define HEADER_SIZE     ALIGNMENT
+#define ALIGN_UP(n)     (((n) + (ALIGNMENT - 1)) & ~(size_t)(ALIGNMENT - 1))
+
+#define FLAG_ALLOC      ((size_t)1)  // block is handed out or cached in a size class
+#define FLAG_PREV_ALLOC ((size_t)2)  // previous physical block is not free
+#define FLAG_SMALL      ((size_t)4)  // block belongs to a small size class
+#define FLAG_MASK       ((size_t)7)
+
+// Small blocks: one LIFO free list per power-of-two size class (32..2048 bytes)
+#define SMALL_CLASS_COUNT 7
+#define SMALL_MIN_PAYLOAD ((size_t)32)
+#define SMALL_MAX_PAYLOAD (SMALL_MIN_PAYLOAD << (SMALL_CLASS_COUNT - 1))
+
+// Large blocks: free lists binned by power of two, first fit within a bin
+#define LARGE_BIN_COUNT 16
+#define MIN_BLOCK_SIZE  ALIGN_UP(HEADER_SIZE + 2 * sizeof(void*) + sizeof(size_t))
+
+// Thread-cache mode: each thread keeps up to two magazines per size class and
+// exchanges full magazines with a lock-free per-class depot.
+#define MAGAZINE_BYTES  1024
+#define MAGAZINE_MIN    2
+
+// Statistics are striped over cache-line-sized slots so that threads bumping
+// counters do not contend; memory_get_stats() sums the stripes.
+#define STATS_STRIPES   16
+#define LARGE_CLASS     SMALL_CLASS_COUNT
+
+_Static_assert(MEMORY_STATS_CLASSES == SMALL_CLASS_COUNT + 1,
+               "stats keep one entry per small class plus one for large blocks");
+
+typedef struct free_block {
+    _Atomic size_t header;
+    struct free_block* next;
+    struct free_block* prev;
+} free_block_t;
+
+typedef struct small_block {
+    _Atomic size_t header;
+    struct small_block* next;
+    // Only meaningful on the first block of a magazine parked in the depot
+    _Atomic uint32_t chain_next;  // pool offset + 1 of the next magazine, 0 = none
+    uint32_t chain_count;         // number of blocks linked through `next`
+    // Small blocks keep FLAG_ALLOC while free, so this marks them instead:
+    // small_free_key(sb) while on a free list or magazine, cleared when handed out
+    uintptr_t free_key;
+} small_block_t;
+
+// The smallest small block still has room for the free key
+_Static_assert(sizeof(small_block_t) <= HEADER_SIZE + SMALL_MIN_PAYLOAD,
+               "small_block_t must fit in the smallest size class");
+
+// Arenas bump-allocate out of a single pool block; the header sits in front
+struct memory_arena {
+    uint8_t* base;
+    size_t capacity;
+    size_t offset;
+};
+
+#define ARENA_HEADER_SIZE ALIGN_UP(sizeof(struct memory_arena))
+
+typedef struct {
+    _Alignas(64) atomic_uint_fast64_t allocs[MEMORY_STATS_CLASSES];
+    atomic_uint_fast64_t frees[MEMORY_STATS_CLASSES];
+    atomic_uint_fast64_t failures[MEMORY_STATS_CLASSES];
+    atomic_uint_fast64_t bytes_requested[MEMORY_STATS_CLASSES];
+} stats_stripe_t;
+
+typedef struct {
+    small_block_t* head[SMALL_CLASS_COUNT];
+    uint32_t count[SMALL_CLASS_COUNT];
+    unsigned generation;
+    bool registered;
+} thread_cache_t;
+
+static _Alignas(ALIGNMENT) uint8_t memory_pool[MEMORY_POOL_SIZE];
+static small_block_t* small_free[SMALL_CLASS_COUNT];
+static free_block_t* large_bins[LARGE_BIN_COUNT];
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Depot heads pack an ABA tag (high 32 bits) with a pool offset + 1 (low 32 bits)
+static _Atomic uint64_t depot[SMALL_CLASS_COUNT];
+
+static memory_mode_t pending_mode = MEMORY_MODE_SHARED;
+static memory_mode_t active_mode = MEMORY_MODE_SHARED;
+static atomic_uint pool_generation = 1;
+
+static pthread_once_t cache_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cache_key;
+static _Thread_local thread_cache_t thread_cache;
+
+static atomic_size_t memory_used = 0;      // live payload bytes
+static atomic_size_t memory_reserved = 0;  // live block bytes, headers included
+static atomic_size_t memory_peak = 0;      // high-water mark of memory_used
+
+static stats_stripe_t stats[STATS_STRIPES];
+static atomic_uint next_stats_stripe = 0;
+static _Thread_local int thread_stats_stripe = -1;
+
+#define POOL_END (memory_pool + MEMORY_POOL_SIZE)
+
+static inline size_t block_size(size_t header) {
+    return header & ~FLAG_MASK;
+}
+
+// Headers are atomic because freeing a block updates the PREV_ALLOC flag of
+// its neighbour, which may be a live block read by its owner without the lock.
+static inline size_t header_load(void* block) {
+    return atomic_load_explicit((_Atomic size_t*)block, memory_order_relaxed);
+}
+
+static inline void header_store(void* block, size_t header) {
+    atomic_store_explicit((_Atomic size_t*)block, header, memory_order_relaxed);
+}
+
+static inline void header_set_flags(void* block, size_t flags) {
+    atomic_fetch_or_explicit((_Atomic size_t*)block, flags, memory_order_relaxed);
+}
+
+static inline void header_clear_flags(void* block, size_t flags) {
+    atomic_fetch_and_explicit((_Atomic size_t*)block, ~flags, memory_order_relaxed);
+}
+
+static inline void write_footer(void* block) {
+    size_t header = header_load(block);
+    *(size_t*)(void*)((uint8_t*)block + block_size(header) - sizeof(size_t)) = header;
+}
+
+static int large_bin_index(size_t size) {
+    int bin = 0;
+    size >>= 6;  // MIN_BLOCK_SIZE and below land in bin 0
+    while (size > 1 && bin < LARGE_BIN_COUNT - 1) {
+        size >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+static void large_insert(free_block_t* fb) {
+    int bin = large_bin_index(block_size(header_load(fb)));
+    fb->prev = NULL;
+    fb->next = large_bins[bin];
+    if (fb->next != NULL) {
+        fb->next->prev = fb;
+    }
+    large_bins[bin] = fb;
+}
+
+static void large_remove(free_block_t* fb) {
+    if (fb->prev != NULL) {
+        fb->prev->next = fb->next;
+    } else {
+        large_bins[large_bin_index(block_size(header_load(fb)))] = fb->next;
+    }
+    if (fb->next != NULL) {
+        fb->next->prev = fb->prev;
+    }
+}
+
+// Take a block of at least `need` bytes from the large free lists, splitting
+// off the remainder when it is big enough to stand on its own.
+static uint8_t* large_take(size_t need) {
+    for (int bin = large_bin_index(need); bin < LARGE_BIN_COUNT; bin++) {
+        for (free_block_t* fb = large_bins[bin]; fb != NULL; fb = fb->next) {
+            size_t header = header_load(fb);
+            size_t size = block_size(header);
+            if (size < need) {
+                continue;
+            }
+
+            large_remove(fb);
+            uint8_t* block = (uint8_t*)fb;
+            size_t prev_flag = header & FLAG_PREV_ALLOC;
+
+            if (size - need >= MIN_BLOCK_SIZE) {
+                free_block_t* rest = (free_block_t*)(void*)(block + need);
+                header_store(rest, (size - need) | FLAG_PREV_ALLOC);
+                write_footer(rest);
+                large_insert(rest);
+                size = need;
+            } else if (block + size < POOL_END) {
+                header_set_flags(block + size, FLAG_PREV_ALLOC);
+            }
+
+            header_store(block, size | prev_flag | FLAG_ALLOC);
+            return block;
+        }
+    }
+    return NULL;
+}
+
+// Return a block to the large free lists, merging it with free neighbours
+static void large_release(uint8_t* block) {
+    size_t header = header_load(block);
+    size_t size = block_size(header);
+
+    uint8_t* next = block + size;
+    if (next < POOL_END) {
+        size_t next_header = header_load(next);
+        if (!(next_header & FLAG_ALLOC)) {
+            large_remove((free_block_t*)(void*)next);
+            size += block_size(next_header);
+        }
+    }
+
+    if (!(header & FLAG_PREV_ALLOC)) {
+        size_t prev_size = block_size(*(size_t*)(void*)(block - sizeof(size_t)));
+        block -= prev_size;
+        large_remove((free_block_t*)(void*)block);
+        size += prev_size;
+        header = header_load(block);
+    }
+
+    header_store(block, size | (header & FLAG_PREV_ALLOC));
+    write_footer(block);
+    large_insert((free_block_t*)(void*)block);
+
+    next = block + size;
+    if (next < POOL_END) {
+        header_clear_flags(next, FLAG_PREV_ALLOC);
+    }
+}
+
+// Address-dependent, so a stale key copied elsewhere does not match
+static inline uintptr_t small_free_key(const small_block_t* sb) {
+    return (uintptr_t)sb ^ (uintptr_t)0x5A17F4EEC0DEB10CULL;
+}
+
+static inline uint32_t pool_offset(small_block_t* sb) {
+    return (uint32_t)((uint8_t*)sb - memory_pool) + 1;
+}
+
+static inline small_block_t* pool_block(uint32_t offset) {
+    return (small_block_t*)(void*)(memory_pool + offset - 1);
+}
+
+static void depot_push(int cls, small_block_t* chain) {
+    uint64_t old = atomic_load_explicit(&depot[cls], memory_order_relaxed);
+    uint64_t desired;
+    do {
+        atomic_store_explicit(&chain->chain_next, (uint32_t)old, memory_order_relaxed);
+        desired = (((old >> 32) + 1) << 32) | pool_offset(chain);
+    } while (!atomic_compare_exchange_weak_explicit(&depot[cls], &old, desired,
+                                                    memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+static small_block_t* depot_pop(int cls) {
+    uint64_t old = atomic_load_explicit(&depot[cls], memory_order_acquire);
+    uint64_t desired;
+    small_block_t* top;
+    do {
+        uint32_t offset = (uint32_t)old;
+        if (offset == 0) {
+            return NULL;
+        }
+        // `top` may be popped and reused concurrently; the tag makes the CAS
+        // fail in that case, and the read itself always stays inside the pool.
+        top = pool_block(offset);
+        uint32_t next = atomic_load_explicit(&top->chain_next, memory_order_relaxed);
+        desired = (((old >> 32) + 1) << 32) | next;
+    } while (!atomic_compare_exchange_weak_explicit(&depot[cls], &old, desired,
+                                                    memory_order_acquire,
+                                                    memory_order_acquire));
+    return top;
+}
+
+// Hand every cached small block back to the large lists so it can coalesce.
+// Caller holds heap_lock; magazines held by other threads stay where they are.
+static void small_flush(void) {
+    for (int cls = 0; cls < SMALL_CLASS_COUNT; cls++) {
+        small_block_t* sb = small_free[cls];
+        small_free[cls] = NULL;
+        while (sb != NULL) {
+            small_block_t* next = sb->next;
+            large_release((uint8_t*)sb);
+            sb = next;
+        }
+
+        small_block_t* chain;
+        while ((chain = depot_pop(cls)) != NULL) {
+            for (sb = chain; sb != NULL; ) {
+                small_block_t* next = sb->next;
+                large_release((uint8_t*)sb);
+                sb = next;
+            }
+        }
+    }
+}
+
+static uint8_t* acquire_block(size_t need) {
+    uint8_t* block = large_take(need);
+    if (block == NULL) {
+        small_flush();
+        block = large_take(need);
+    }
+    return block;
+}
+
+static int small_class_index(size_t size) {
+    int cls = 0;
+    size_t payload = SMALL_MIN_PAYLOAD;
+    while (payload < size) {
+        payload <<= 1;
+        cls++;
+    }
+    return cls;
+}
+
+// A small block may carry a few bytes of split slack, so map it to the
+// largest class whose payload it can still hold.
+static int small_class_of_block(size_t size) {
+    int cls = 0;
+    size_t payload = size - HEADER_SIZE;
+    while (cls < SMALL_CLASS_COUNT - 1 && (SMALL_MIN_PAYLOAD << (cls + 1)) <= payload) {
+        cls++;
+    }
+    return cls;
+}
+
+static inline uint32_t magazine_size(int cls) {
+    size_t n = MAGAZINE_BYTES / (SMALL_MIN_PAYLOAD << cls);
+    return n < MAGAZINE_MIN ? MAGAZINE_MIN : (uint32_t)n;
+}
+
+// Carve one contiguous region into a full magazine of small blocks
+static small_block_t* carve_magazine(int cls) {
+    size_t bsize = (SMALL_MIN_PAYLOAD << cls) + HEADER_SIZE;
+    uint32_t count = magazine_size(cls);
+
+    pthread_mutex_lock(&heap_lock);
+    uint8_t* region = acquire_block(bsize * count);
+    pthread_mutex_unlock(&heap_lock);
+    if (region == NULL) {
+        return NULL;
+    }
+
+    size_t region_header = header_load(region);
+    size_t region_size = block_size(region_header);
+    size_t prev_flag = region_header & FLAG_PREV_ALLOC;
+    small_block_t* head = NULL;
+    for (uint32_t i = count; i-- > 0; ) {
+        small_block_t* sb = (small_block_t*)(void*)(region + i * bsize);
+        // Split slack goes to the last block; everything before it is allocated
+        size_t size = (i == count - 1) ? region_size - i * bsize : bsize;
+        header_store(sb, size | FLAG_ALLOC | FLAG_SMALL | (i == 0 ? prev_flag : FLAG_PREV_ALLOC));
+        sb->next = head;
+        head = sb;
+    }
+    head->chain_count = count;
+    return head;
+}
+
+static void thread_cache_release(void* arg) {
+    thread_cache_t* tc = (thread_cache_t*)arg;
+    if (tc->generation != atomic_load_explicit(&pool_generation, memory_order_acquire)) {
+        return;  // pool was reset since these blocks were cached
+    }
+    for (int cls = 0; cls < SMALL_CLASS_COUNT; cls++) {
+        if (tc->head[cls] != NULL) {
+            tc->head[cls]->chain_count = tc->count[cls];
+            depot_push(cls, tc->head[cls]);
+            tc->head[cls] = NULL;
+            tc->count[cls] = 0;
+        }
+    }
+}
+
+static void cache_key_create(void) {
+    pthread_key_create(&cache_key, thread_cache_release);
+}
+
+static thread_cache_t* thread_cache_get(void) {
+    thread_cache_t* tc = &thread_cache;
+    unsigned generation = atomic_load_explicit(&pool_generation, memory_order_acquire);
+    if (tc->generation != generation) {
+        for (int cls = 0; cls < SMALL_CLASS_COUNT; cls++) {
+            tc->head[cls] = NULL;
+            tc->count[cls] = 0;
+        }
+        tc->generation = generation;
+    }
+    if (!tc->registered) {
+        // Return this thread's magazines to the depot when it exits
+        pthread_once(&cache_key_once, cache_key_create);
+        pthread_setspecific(cache_key, tc);
+        tc->registered = true;
+    }
+    return tc;
+}
+
+static small_block_t* thread_cache_alloc(int cls) {
+    thread_cache_t* tc = thread_cache_get();
+    small_block_t* sb = tc->head[cls];
+    if (sb == NULL) {
+        sb = depot_pop(cls);
+        if (sb == NULL) {
+            sb = carve_magazine(cls);
+            if (sb == NULL) {
+                return NULL;
+            }
+        }
+        tc->count[cls] = sb->chain_count;
+    }
+    tc->head[cls] = sb->next;
+    tc->count[cls]--;
+    return sb;
+}
+
+static void thread_cache_free(int cls, small_block_t* sb) {
+    thread_cache_t* tc = thread_cache_get();
+    uint32_t magazine = magazine_size(cls);
+    if (tc->count[cls] >= 2 * magazine) {
+        // Both magazines are full: park one in the depot for other threads
+        small_block_t* chain = tc->head[cls];
+        small_block_t* tail = chain;
+        for (uint32_t i = 1; i < magazine; i++) {
+            tail = tail->next;
+        }
+        tc->head[cls] = tail->next;
+        tc->count[cls] -= magazine;
+        tail->next = NULL;
+        chain->chain_count = magazine;
+        depot_push(cls, chain);
+    }
+    sb->next = tc->head[cls];
+    tc->head[cls] = sb;
+    tc->count[cls]++;
+}
+
+static inline stats_stripe_t* stats_local(void) {
+    if (thread_stats_stripe < 0) {
+        thread_stats_stripe = (int)(atomic_fetch_add_explicit(&next_stats_stripe, 1,
+                                                              memory_order_relaxed) % STATS_STRIPES);
+    }
+    return &stats[thread_stats_stripe];
+}
+
+static inline void stat_add(atomic_uint_fast64_t* counter, uint64_t n) {
+    atomic_fetch_add_explicit(counter, n, memory_order_relaxed);
+}
+
+static inline void peak_update(size_t used) {
+    size_t peak = atomic_load_explicit(&memory_peak, memory_order_relaxed);
+    while (used > peak &&
+           !atomic_compare_exchange_weak_explicit(&memory_peak, &peak, used,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+static void memory_reset(void) {
+    pthread_mutex_lock(&heap_lock);
+
+    for (int i = 0; i < SMALL_CLASS_COUNT; i++) {
+        small_free[i] = NULL;
+        atomic_store_explicit(&depot[i], 0, memory_order_relaxed);
+    }
+    for (int i = 0; i < LARGE_BIN_COUNT; i++) {
+        large_bins[i] = NULL;
+    }
+
+    header_store(memory_pool, MEMORY_POOL_SIZE | FLAG_PREV_ALLOC);
+    write_footer(memory_pool);
+    large_insert((free_block_t*)(void*)memory_pool);
+
+    active_mode = pending_mode;
+    atomic_fetch_add_explicit(&pool_generation, 1, memory_order_release);
+    atomic_store_explicit(&memory_used, 0, memory_order_relaxed);
+    atomic_store_explicit(&memory_reserved, 0, memory_order_relaxed);
+    atomic_store_explicit(&memory_peak, 0, memory_order_relaxed);
+
+    for (int i = 0; i < STATS_STRIPES; i++) {
+        for (int cls = 0; cls < MEMORY_STATS_CLASSES; cls++) {
+            atomic_store_explicit(&stats[i].allocs[cls], 0, memory_order_relaxed);
+            atomic_store_explicit(&stats[i].frees[cls], 0, memory_order_relaxed);
+            atomic_store_explicit(&stats[i].failures[cls], 0, memory_order_relaxed);
+            atomic_store_explicit(&stats[i].bytes_requested[cls], 0, memory_order_relaxed);
+        }
+    }
+
+    pthread_mutex_unlock(&heap_lock);
+}
 
 int memory_init(void) {
-    memory_used = 0;
-    printf("Memory pool initialized (%zu bytes)\n", MEMORY_POOL_SIZE);
+    memory_reset();
+    LOG_INFO("Memory pool initialized (%zu bytes)", MEMORY_POOL_SIZE);
     return 0;
 }
 
 void memory_cleanup(void) {
-    memory_used = 0;
+#ifdef ENABLE_DEBUG_LOGS
+    memory_print_stats();
+#endif
+    memory_reset();
 }
 
-void* memory_alloc(size_t size) {
-    // Simple bump allocator
-    size_t aligned_size = (size + 7) & ~7;  // 8-byte alignment
+void memory_set_mode(memory_mode_t mode) {
+    pending_mode = mode;
+}
+
+memory_mode_t memory_get_mode(void) {
+    return active_mode;
+}
 
-    if (memory_used + aligned_size > MEMORY_POOL_SIZE) {
+static void* pool_alloc(size_t size) {
+    stats_stripe_t* local = stats_local();
+    if (size > MEMORY_POOL_SIZE - HEADER_SIZE) {
+        stat_add(&local->failures[LARGE_CLASS], 1);
         return NULL;
     }
 
-    void* ptr = &memory_pool[memory_used];
-    memory_used += aligned_size;
+    uint8_t* block;
+    int cls = LARGE_CLASS;
+    if (size <= SMALL_MAX_PAYLOAD) {
+        // Small request: O(1) pop from its size class, or carve a new block
+        cls = small_class_index(size);
+        if (active_mode == MEMORY_MODE_THREAD_CACHE) {
+            block = (uint8_t*)thread_cache_alloc(cls);
+        } else {
+            pthread_mutex_lock(&heap_lock);
+            small_block_t* sb = small_free[cls];
+            if (sb != NULL) {
+                small_free[cls] = sb->next;
+                block = (uint8_t*)sb;
+            } else {
+                block = acquire_block((SMALL_MIN_PAYLOAD << cls) + HEADER_SIZE);
+                if (block != NULL) {
+                    header_set_flags(block, FLAG_SMALL);
+                }
+            }
+            pthread_mutex_unlock(&heap_lock);
+        }
+    } else {
+        pthread_mutex_lock(&heap_lock);
+        block = acquire_block(ALIGN_UP(size) + HEADER_SIZE);
+        pthread_mutex_unlock(&heap_lock);
+    }
 
-    // Use math library function
-    double usage_percent = (double)memory_used / MEMORY_POOL_SIZE * 100.0;
-    printf("Memory allocated: %zu bytes (%.2f%% used)\n", size, usage_percent);
+    if (block == NULL) {
+        stat_add(&local->failures[cls], 1);
+        return NULL;
+    }
+    if (cls != LARGE_CLASS) {
+        ((small_block_t*)(void*)block)->free_key = 0;
+    }
+
+    size_t bsize = block_size(header_load(block));
+    atomic_fetch_add_explicit(&memory_reserved, bsize, memory_order_relaxed);
+    size_t used = atomic_fetch_add_explicit(&memory_used, bsize - HEADER_SIZE,
+                                            memory_order_relaxed) + bsize - HEADER_SIZE;
+    peak_update(used);
+    stat_add(&local->allocs[cls], 1);
+    stat_add(&local->bytes_requested[cls], size);
+
+    LOG_DEBUG("Memory allocated: %zu bytes (%zu bytes in use)", size, used);
+
+    return block + HEADER_SIZE;
+}
 
+static void pool_free(void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    uint8_t* block = (uint8_t*)ptr - HEADER_SIZE;
+    if (block < memory_pool || block >= POOL_END) {
+        return;  // not from this pool
+    }
+
+    size_t header = header_load(block);
+    if (!(header & FLAG_ALLOC)) {
+        return;  // already free
+    }
+
+    small_block_t* sb = (small_block_t*)(void*)block;
+    if ((header & FLAG_SMALL) && sb->free_key == small_free_key(sb)) {
+        LOG_WARN("Double free of %p ignored", ptr);
+        return;
+    }
+
+    size_t bsize = block_size(header);
+    atomic_fetch_sub_explicit(&memory_reserved, bsize, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&memory_used, bsize - HEADER_SIZE, memory_order_relaxed);
+    stats_stripe_t* local = stats_local();
+
+    if (header & FLAG_SMALL) {
+        // Stays marked allocated so neighbours never coalesce into it
+        sb->free_key = small_free_key(sb);
+        int cls = small_class_of_block(bsize);
+        stat_add(&local->frees[cls], 1);
+        if (active_mode == MEMORY_MODE_THREAD_CACHE) {
+            thread_cache_free(cls, sb);
+        } else {
+            pthread_mutex_lock(&heap_lock);
+            sb->next = small_free[cls];
+            small_free[cls] = sb;
+            pthread_mutex_unlock(&heap_lock);
+        }
+    } else {
+        stat_add(&local->frees[LARGE_CLASS], 1);
+        pthread_mutex_lock(&heap_lock);
+        large_release(block);
+        pthread_mutex_unlock(&heap_lock);
+    }
+}
+
+void* memory_alloc(size_t size) {
+    TRACE_BEGIN(start);
+    void* ptr = pool_alloc(size);
+    TRACE_END(TRACE_MEMORY_ALLOC, start, size);
     return ptr;
 }
 
 void memory_free(void* ptr) {
-    // Simplified - does not actually free in this implementation
-    (void)ptr;
+    TRACE_BEGIN(start);
+    pool_free(ptr);
+    TRACE_END(TRACE_MEMORY_FREE, start, 0);
 }
 
 size_t memory_get_used(void) {
-    return memory_used;
+    return atomic_load_explicit(&memory_used, memory_order_relaxed);
 }
 
 size_t memory_get_available(void) {
-    return MEMORY_POOL_SIZE - memory_used;
+    return MEMORY_POOL_SIZE - atomic_load_explicit(&memory_reserved, memory_order_relaxed);
+}
+
+void memory_get_stats(memory_stats_t* out) {
+    if (out == NULL) {
+        return;
+    }
+
+    *out = (memory_stats_t){0};
+    for (int cls = 0; cls < MEMORY_STATS_CLASSES; cls++) {
+        memory_class_stats_t* c = &out->classes[cls];
+        c->max_size = cls == LARGE_CLASS ? SIZE_MAX : SMALL_MIN_PAYLOAD << cls;
+        for (int i = 0; i < STATS_STRIPES; i++) {
+            c->allocs += atomic_load_explicit(&stats[i].allocs[cls], memory_order_relaxed);
+            c->frees += atomic_load_explicit(&stats[i].frees[cls], memory_order_relaxed);
+            c->failures += atomic_load_explicit(&stats[i].failures[cls], memory_order_relaxed);
+            c->bytes_requested += atomic_load_explicit(&stats[i].bytes_requested[cls],
+                                                       memory_order_relaxed);
+        }
+        out->allocs += c->allocs;
+        out->frees += c->frees;
+        out->failures += c->failures;
+        out->bytes_requested += c->bytes_requested;
+    }
+
+    out->used = memory_get_used();
+    out->peak_used = atomic_load_explicit(&memory_peak, memory_order_relaxed);
+    out->available = memory_get_available();
+}
+
+void memory_print_stats(void) {
+    memory_stats_t st;
+    memory_get_stats(&st);
+
+    printf("Memory stats: used=%zu peak=%zu available=%zu\n",
+           st.used, st.peak_used, st.available);
+    printf("  %-8s %10s %10s %10s %14s\n", "class", "allocs", "frees", "failures", "bytes");
+    for (int cls = 0; cls < MEMORY_STATS_CLASSES; cls++) {
+        const memory_class_stats_t* c = &st.classes[cls];
+        if (cls == LARGE_CLASS) {
+            printf("  %-8s", "large");
+        } else {
+            printf("  <=%-6zu", c->max_size);
+        }
+        printf(" %10llu %10llu %10llu %14llu\n",
+               (unsigned long long)c->allocs, (unsigned long long)c->frees,
+               (unsigned long long)c->failures, (unsigned long long)c->bytes_requested);
+    }
+}
+
+memory_arena_t* memory_arena_create(size_t capacity) {
+    // Range check first: ALIGN_UP wraps to 0 near SIZE_MAX
+    if (capacity > MEMORY_POOL_SIZE) {
+        return NULL;
+    }
+    capacity = ALIGN_UP(capacity);
+
+    uint8_t* block = (uint8_t*)memory_alloc(ARENA_HEADER_SIZE + capacity);
+    if (block == NULL) {
+        return NULL;
+    }
+
+    memory_arena_t* arena = (memory_arena_t*)(void*)block;
+    arena->base = block + ARENA_HEADER_SIZE;
+    arena->capacity = capacity;
+    arena->offset = 0;
+    return arena;
+}
+
+void* memory_arena_alloc(memory_arena_t* arena, size_t size) {
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    // Same bump logic the pool used to have, bounded by the arena block
+    size_t aligned_size = ALIGN_UP(size);
+    if (aligned_size < size || aligned_size > arena->capacity - arena->offset) {
+        return NULL;
+    }
+
+    void* ptr = arena->base + arena->offset;
+    arena->offset += aligned_size;
+    return ptr;
+}
+
+size_t memory_arena_mark(const memory_arena_t* arena) {
+    return arena != NULL ? arena->offset : 0;
+}
+
+void memory_arena_rewind(memory_arena_t* arena, size_t mark) {
+    if (arena != NULL && mark <= arena->offset) {
+        arena->offset = mark;
+    }
+}
+
+void memory_arena_reset(memory_arena_t* arena) {
+    memory_arena_rewind(arena, 0);
+}
+
+size_t memory_arena_used(const memory_arena_t* arena) {
+    return memory_arena_mark(arena);
+}
+
+void memory_arena_destroy(memory_arena_t* arena) {
+    memory_free(arena);
 }
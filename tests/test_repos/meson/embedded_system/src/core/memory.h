@@ -3,18 +3,73 @@
 
 #include <stddef.h>
 #include <stdint.h>
-#include <math.h>
+
+// Allocation modes
+typedef enum {
+    MEMORY_MODE_SHARED = 0,       // every call goes through the shared pool lock
+    MEMORY_MODE_THREAD_CACHE = 1  // per-thread magazines backed by a lock-free depot
+} memory_mode_t;
 
 // Memory pool management
 int memory_init(void);
 void memory_cleanup(void);
 
+// Select the allocation mode; takes effect at the next memory_init()
+void memory_set_mode(memory_mode_t mode);
+memory_mode_t memory_get_mode(void);
+
 // Memory allocation
+// Requests up to 2 KB are served from power-of-two size classes in O(1);
+// larger ones come from binned free lists and coalesce with free neighbours.
 void* memory_alloc(size_t size);
 void memory_free(void* ptr);
 
+// Arenas: bump allocation inside one pool block, for objects that die together
+// (e.g. everything built for one protocol message). Individual allocations are
+// never freed; reset/rewind reclaims them all in O(1). Not thread-safe: an
+// arena belongs to one thread at a time.
+typedef struct memory_arena memory_arena_t;
+
+memory_arena_t* memory_arena_create(size_t capacity);
+void* memory_arena_alloc(memory_arena_t* arena, size_t size);
+void memory_arena_reset(memory_arena_t* arena);
+void memory_arena_destroy(memory_arena_t* arena);
+
+// Scoped reset: rewind to a mark taken earlier, dropping later allocations
+size_t memory_arena_mark(const memory_arena_t* arena);
+void memory_arena_rewind(memory_arena_t* arena, size_t mark);
+size_t memory_arena_used(const memory_arena_t* arena);
+
 // Memory statistics
-size_t memory_get_used(void);
-size_t memory_get_available(void);
+size_t memory_get_used(void);       // payload bytes held by live allocations
+size_t memory_get_available(void);  // pool bytes not held by live allocations
+
+// Allocation statistics, kept as integer counters per size class
+#define MEMORY_STATS_CLASSES 8  // seven small size classes plus one for large blocks
+
+typedef struct {
+    size_t max_size;             // largest request the class serves (SIZE_MAX for large)
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t failures;
+    uint64_t bytes_requested;
+} memory_class_stats_t;
+
+typedef struct {
+    uint64_t allocs;
+    uint64_t frees;
+    uint64_t failures;
+    uint64_t bytes_requested;
+    size_t used;
+    size_t peak_used;
+    size_t available;
+    memory_class_stats_t classes[MEMORY_STATS_CLASSES];  // size histogram
+} memory_stats_t;
+
+// Snapshot the counters; cheap enough to poll, never called on the alloc path
+void memory_get_stats(memory_stats_t* stats);
+
+// Print the counters (also done by memory_cleanup() when debug logs are enabled)
+void memory_print_stats(void);
 
 #endif // MEMORY_H
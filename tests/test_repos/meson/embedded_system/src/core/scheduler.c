@@ -0,0 +1,398 @@
+#if defined(__linux__)
+#define _GNU_SOURCE  // pthread_setaffinity_np
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "scheduler.h"
+#include "log.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define DEFAULT_ARENA_SIZE 4096
+#define DEFAULT_QUEUE_CAPACITY 1024
+#define MAX_QUEUE_CAPACITY 1024
+#define MAX_WORKERS 64
+
+// Slots are written by the owner and read racily by thieves; a thief whose
+// claim on `top` fails discards what it read, so each half is atomic alone
+typedef struct {
+    _Atomic(scheduler_task_fn) fn;
+    _Atomic(void*) arg;
+} task_slot_t;
+
+// Chase-Lev deque with a fixed ring: the owner pushes and pops at bottom,
+// thieves take from top
+typedef struct {
+    _Alignas(64) atomic_size_t top;
+    _Alignas(64) atomic_size_t bottom;
+    task_slot_t* slots;
+    size_t mask;
+} task_deque_t;
+
+typedef struct {
+    _Alignas(64) task_deque_t deque;
+    memory_arena_t* arena;
+    pthread_t thread;
+    size_t index;
+    uint32_t rng;
+} worker_t;
+
+// Workers are cache-line aligned, so they live in static storage rather
+// than in (8-byte aligned) pool blocks. Their deques and the injection
+// queue do too: at 16 KB a worker they would crowd message traffic out of
+// the pool on many-core hosts.
+static worker_t workers[MAX_WORKERS];
+static task_slot_t deque_slots[MAX_WORKERS][MAX_QUEUE_CAPACITY];
+static task_slot_t inject_slots[MAX_QUEUE_CAPACITY];
+
+static struct {
+    worker_t* workers;
+    size_t count;
+    scheduler_config_t config;
+
+    // Injection queue for tasks submitted from outside the pool
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t idle;
+    task_slot_t* inject;
+    size_t inject_head;
+    size_t inject_tail;
+    size_t sleepers;
+
+    _Alignas(64) atomic_size_t outstanding;
+    atomic_size_t steals;
+    atomic_bool running;
+} pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work = PTHREAD_COND_INITIALIZER,
+    .idle = PTHREAD_COND_INITIALIZER,
+};
+
+static _Thread_local worker_t* current_worker = NULL;
+
+static bool deque_push(task_deque_t* d, scheduler_task_fn fn, void* arg) {
+    size_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    size_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - t > d->mask) {
+        return false;
+    }
+
+    task_slot_t* slot = &d->slots[b & d->mask];
+    atomic_store_explicit(&slot->fn, fn, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg, arg, memory_order_relaxed);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+static bool deque_pop(task_deque_t* d, scheduler_task_fn* fn, void** arg) {
+    size_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    if (b == atomic_load_explicit(&d->top, memory_order_relaxed)) {
+        return false;
+    }
+
+    b--;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    size_t t = atomic_load_explicit(&d->top, memory_order_relaxed);
+
+    if (t > b) {
+        // A thief took the last task
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+
+    task_slot_t* slot = &d->slots[b & d->mask];
+    *fn = atomic_load_explicit(&slot->fn, memory_order_relaxed);
+    *arg = atomic_load_explicit(&slot->arg, memory_order_relaxed);
+    if (t == b) {
+        // Last task: race thieves for it through top
+        bool won = atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                           memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+static bool deque_steal(task_deque_t* d, scheduler_task_fn* fn, void** arg) {
+    size_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    size_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) {
+        return false;
+    }
+
+    task_slot_t* slot = &d->slots[t & d->mask];
+    *fn = atomic_load_explicit(&slot->fn, memory_order_relaxed);
+    *arg = atomic_load_explicit(&slot->arg, memory_order_relaxed);
+    return atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1,
+                                                   memory_order_seq_cst, memory_order_relaxed);
+}
+
+static bool inject_pop(scheduler_task_fn* fn, void** arg) {
+    if (pool.inject_head == pool.inject_tail) {
+        return false;
+    }
+    task_slot_t* slot = &pool.inject[pool.inject_head & (pool.config.queue_capacity - 1)];
+    *fn = atomic_load_explicit(&slot->fn, memory_order_relaxed);
+    *arg = atomic_load_explicit(&slot->arg, memory_order_relaxed);
+    pool.inject_head++;
+    return true;
+}
+
+static bool find_task(worker_t* self, scheduler_task_fn* fn, void** arg) {
+    if (deque_pop(&self->deque, fn, arg)) {
+        return true;
+    }
+
+    // Random starting victim so thieves spread out
+    self->rng ^= self->rng << 13;
+    self->rng ^= self->rng >> 17;
+    self->rng ^= self->rng << 5;
+    size_t start = self->rng % pool.count;
+    for (size_t i = 0; i < pool.count; i++) {
+        worker_t* victim = &pool.workers[(start + i) % pool.count];
+        if (victim != self && deque_steal(&victim->deque, fn, arg)) {
+            atomic_fetch_add_explicit(&pool.steals, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void task_done(void) {
+    if (atomic_fetch_sub_explicit(&pool.outstanding, 1, memory_order_acq_rel) == 1) {
+        pthread_mutex_lock(&pool.lock);
+        pthread_cond_broadcast(&pool.idle);
+        pthread_mutex_unlock(&pool.lock);
+    }
+}
+
+static bool any_deque_busy(void) {
+    for (size_t i = 0; i < pool.count; i++) {
+        task_deque_t* d = &pool.workers[i].deque;
+        if (atomic_load_explicit(&d->top, memory_order_acquire) <
+            atomic_load_explicit(&d->bottom, memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void pin_to_cpu(size_t cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        LOG_WARN("Scheduler: could not pin worker %zu", cpu);
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+static void* worker_main(void* arg) {
+    worker_t* self = arg;
+    current_worker = self;
+    if (pool.config.pin_threads) {
+        pin_to_cpu(self->index);
+    }
+
+    for (;;) {
+        scheduler_task_fn fn;
+        void* task_arg;
+        bool found = find_task(self, &fn, &task_arg);
+
+        if (!found) {
+            pthread_mutex_lock(&pool.lock);
+            found = inject_pop(&fn, &task_arg);
+            if (!found) {
+                if (!atomic_load_explicit(&pool.running, memory_order_acquire)) {
+                    pthread_mutex_unlock(&pool.lock);
+                    break;
+                }
+                // Spawned tasks sit in deques without touching the lock, so
+                // only sleep when there is nothing left to steal either
+                if (!any_deque_busy()) {
+                    pool.sleepers++;
+                    pthread_cond_wait(&pool.work, &pool.lock);
+                    pool.sleepers--;
+                }
+            }
+            pthread_mutex_unlock(&pool.lock);
+        }
+
+        if (found) {
+            memory_arena_reset(self->arena);
+            fn(task_arg, self->arena);
+            task_done();
+        }
+    }
+
+    current_worker = NULL;
+    return NULL;
+}
+
+static void wake_one(void) {
+    pthread_mutex_lock(&pool.lock);
+    if (pool.sleepers > 0) {
+        pthread_cond_signal(&pool.work);
+    }
+    pthread_mutex_unlock(&pool.lock);
+}
+
+int scheduler_submit(scheduler_task_fn fn, void* arg) {
+    if (fn == NULL || !atomic_load_explicit(&pool.running, memory_order_acquire)) {
+        return -1;
+    }
+
+    atomic_fetch_add_explicit(&pool.outstanding, 1, memory_order_relaxed);
+    worker_t* self = current_worker;
+    if (self != NULL && deque_push(&self->deque, fn, arg)) {
+        wake_one();
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    if (pool.inject_tail - pool.inject_head >= pool.config.queue_capacity) {
+        pthread_mutex_unlock(&pool.lock);
+        task_done();
+        return -1;
+    }
+    task_slot_t* slot = &pool.inject[pool.inject_tail & (pool.config.queue_capacity - 1)];
+    atomic_store_explicit(&slot->fn, fn, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg, arg, memory_order_relaxed);
+    pool.inject_tail++;
+    if (pool.sleepers > 0) {
+        pthread_cond_signal(&pool.work);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return 0;
+}
+
+void scheduler_wait(void) {
+    pthread_mutex_lock(&pool.lock);
+    while (atomic_load_explicit(&pool.outstanding, memory_order_acquire) > 0) {
+        pthread_cond_wait(&pool.idle, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+}
+
+static void release_workers(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        memory_arena_destroy(pool.workers[i].arena);
+        pool.workers[i].deque.slots = NULL;
+    }
+    pool.workers = NULL;
+    pool.inject = NULL;
+    pool.count = 0;
+}
+
+int scheduler_start(const scheduler_config_t* config) {
+    if (atomic_load_explicit(&pool.running, memory_order_acquire)) {
+        return -1;
+    }
+
+    scheduler_config_t cfg = {0};
+    if (config != NULL) {
+        cfg = *config;
+    }
+    if (cfg.threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        cfg.threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (cfg.threads > MAX_WORKERS) {
+        cfg.threads = MAX_WORKERS;
+    }
+    if (cfg.arena_size == 0) {
+        cfg.arena_size = DEFAULT_ARENA_SIZE;
+    }
+    if (cfg.queue_capacity == 0) {
+        cfg.queue_capacity = DEFAULT_QUEUE_CAPACITY;
+    }
+    if ((cfg.queue_capacity & (cfg.queue_capacity - 1)) != 0 || cfg.queue_capacity > MAX_QUEUE_CAPACITY) {
+        return -1;
+    }
+
+    pool.config = cfg;
+    pool.workers = workers;
+    pool.inject = inject_slots;
+    pool.inject_head = 0;
+    pool.inject_tail = 0;
+
+    size_t ready = 0;
+    for (; ready < cfg.threads; ready++) {
+        worker_t* w = &pool.workers[ready];
+        w->deque.slots = deque_slots[ready];
+        w->arena = memory_arena_create(cfg.arena_size);
+        if (w->arena == NULL) {
+            break;
+        }
+        atomic_init(&w->deque.top, 0);
+        atomic_init(&w->deque.bottom, 0);
+        w->deque.mask = cfg.queue_capacity - 1;
+        w->index = ready;
+        w->rng = (uint32_t)(ready * 2654435761u) | 1u;
+    }
+    if (ready < cfg.threads) {
+        release_workers(ready);
+        return -1;
+    }
+    pool.count = cfg.threads;
+
+    atomic_store_explicit(&pool.running, true, memory_order_release);
+    size_t started = 0;
+    for (; started < pool.count; started++) {
+        if (pthread_create(&pool.workers[started].thread, NULL, worker_main, &pool.workers[started]) != 0) {
+            break;
+        }
+    }
+    if (started < pool.count) {
+        // Fail as a whole: stop and join the workers that did start before
+        // their deques and arenas go away
+        LOG_ERROR("Scheduler: started %zu of %zu workers", started, pool.count);
+        pthread_mutex_lock(&pool.lock);
+        atomic_store_explicit(&pool.running, false, memory_order_release);
+        pthread_cond_broadcast(&pool.work);
+        pthread_mutex_unlock(&pool.lock);
+        for (size_t i = 0; i < started; i++) {
+            pthread_join(pool.workers[i].thread, NULL);
+        }
+        release_workers(pool.count);
+        return -1;
+    }
+
+    LOG_INFO("Scheduler started with %zu workers%s", pool.count, cfg.pin_threads ? " (pinned)" : "");
+    return 0;
+}
+
+void scheduler_stop(void) {
+    if (!atomic_load_explicit(&pool.running, memory_order_acquire)) {
+        return;
+    }
+
+    // Tasks may still spawn tasks, so drain before refusing new ones
+    scheduler_wait();
+    atomic_store_explicit(&pool.running, false, memory_order_release);
+
+    pthread_mutex_lock(&pool.lock);
+    pthread_cond_broadcast(&pool.work);
+    pthread_mutex_unlock(&pool.lock);
+    for (size_t i = 0; i < pool.count; i++) {
+        pthread_join(pool.workers[i].thread, NULL);
+    }
+    release_workers(pool.count);
+}
+
+size_t scheduler_thread_count(void) {
+    return pool.count;
+}
+
+size_t scheduler_steal_count(void) {
+    return atomic_load_explicit(&pool.steals, memory_order_relaxed);
+}
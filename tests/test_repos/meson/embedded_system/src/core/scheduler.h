@@ -0,0 +1,43 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "memory.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// Work-stealing task pool. Each worker owns a deque: tasks it spawns go to
+// its own bottom, idle workers steal from other workers' tops. Tasks
+// submitted from outside the pool go through a shared injection queue.
+
+// A task gets its argument and its worker's arena, reset before every task,
+// for scratch memory that dies with the task
+typedef void (*scheduler_task_fn)(void* arg, memory_arena_t* arena);
+
+typedef struct {
+    size_t threads;         // Workers; 0 uses one per online CPU
+    bool pin_threads;       // Pin worker i to CPU i (ignored where unsupported)
+    size_t arena_size;      // Per-worker task arena bytes (4096)
+    size_t queue_capacity;  // Per-deque and injection slots, power of two
+                            // up to 1024 (1024)
+} scheduler_config_t;
+
+// Start the pool; memory_init() must have run (arenas come from the pool).
+// Returns -1, with nothing left running, if any worker fails to start.
+int scheduler_start(const scheduler_config_t* config);
+
+// Queue a task. From a worker it lands on that worker's deque. Returns -1
+// when the pool is not running or the target queue is full.
+int scheduler_submit(scheduler_task_fn fn, void* arg);
+
+// Block until every submitted task has finished
+void scheduler_wait(void);
+
+// Finish outstanding tasks, then join and release the workers
+void scheduler_stop(void);
+
+size_t scheduler_thread_count(void);
+
+// Tasks run so far that a worker stole from another worker's deque
+size_t scheduler_steal_count(void);
+
+#endif // SCHEDULER_H
@@ -1,25 +1,103 @@
 #include "system.h"
 #include "memory.h"
-#include <stdio.h>
+#include "log.h"
+#include <stdatomic.h>
+#include <string.h>
 #include <stdlib.h>
 
-static system_status_t current_status = SYSTEM_STATUS_OK;
+// Read by every driver call from any thread. Alignment gives it a cache line
+// of its own, so readers never contend with neighbouring writes.
+static struct {
+    _Alignas(64) _Atomic(system_status_t) value;
+} current_status = {SYSTEM_STATUS_OK};
+
+_Static_assert(sizeof(system_config_t) == 16, "system_config_t must stay packed");
+
+static system_config_t active_config = {
+    .magic = SYSTEM_CONFIG_MAGIC,
+    .version = SYSTEM_CONFIG_VERSION,
+    .size = sizeof(system_config_t),
+};
+
+// Bitwise CRC-32 (IEEE); it runs once at boot over twelve bytes
+static uint32_t crc32_update(uint32_t crc, const uint8_t* data, size_t length) {
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t config_checksum(const system_config_t* config) {
+    const uint8_t bytes[12] = {
+        (uint8_t)config->magic, (uint8_t)(config->magic >> 8),
+        (uint8_t)(config->magic >> 16), (uint8_t)(config->magic >> 24),
+        (uint8_t)config->version, (uint8_t)(config->version >> 8),
+        (uint8_t)config->size, (uint8_t)(config->size >> 8),
+        config->debug_mode, 0, 0, 0
+    };
+    return crc32_update(0, bytes, sizeof(bytes));
+}
 
 int system_init(void) {
-    printf("System initializing (version %s)...\n", VERSION);
+#ifdef ENABLE_DEBUG
+    // Calibrate the trace clock before the first tracepoint fires
+    trace_init();
+#endif
+    log_start();
+    LOG_INFO("System initializing (version %s)...", VERSION);
+
+    // Config comes from the linked-in snapshot: no parsing, no allocation
+    if (system_load_config_snapshot(&system_config_snapshot, sizeof(system_config_snapshot)) != 0) {
+        LOG_WARN("Config snapshot rejected, using defaults");
+    }
 
     // Initialize memory subsystem
     if (memory_init() != 0) {
-        current_status = SYSTEM_STATUS_ERROR;
+        system_set_status(SYSTEM_STATUS_ERROR);
         return -1;
     }
 
-    current_status = SYSTEM_STATUS_OK;
+    system_set_status(SYSTEM_STATUS_OK);
     return 0;
 }
 
 system_status_t system_get_status(void) {
-    return current_status;
+    // The status is one word, so the seqlock read degenerates to a single
+    // acquire load: no lock, no retry, no write to a shared line
+    return atomic_load_explicit(&current_status.value, memory_order_acquire);
+}
+
+void system_set_status(system_status_t status) {
+    // Release: whatever the writer did before publishing is visible to
+    // readers that observe the new status
+    atomic_store_explicit(&current_status.value, status, memory_order_release);
+}
+
+int system_load_config_snapshot(const void* data, size_t size) {
+    if (data == NULL || size < sizeof(system_config_t)) {
+        return -1;
+    }
+
+    system_config_t config;
+    memcpy(&config, data, sizeof(config));
+    if (config.magic != SYSTEM_CONFIG_MAGIC ||
+        config.version != SYSTEM_CONFIG_VERSION ||
+        config.size != sizeof(system_config_t) ||
+        config.checksum != config_checksum(&config)) {
+        return -1;
+    }
+
+    active_config = config;
+    LOG_INFO("Debug mode: %d", active_config.debug_mode);
+    return 0;
+}
+
+const system_config_t* system_get_config(void) {
+    return &active_config;
 }
 
 int system_load_config(struct json_object *config) {
@@ -31,14 +109,30 @@ int system_load_config(struct json_object *config) {
     struct json_object *obj;
     if (json_object_object_get_ex(config, "debug_mode", &obj)) {
         int debug_mode = json_object_get_boolean(obj);
-        printf("Debug mode: %d\n", debug_mode);
+        LOG_INFO("Debug mode: %d", debug_mode);
+        active_config.debug_mode = debug_mode ? 1 : 0;
+        active_config.checksum = config_checksum(&active_config);
     }
 
     return 0;
 }
 
+int system_get_metrics(system_metrics_t* metrics) {
+    if (metrics == NULL) {
+        return -1;
+    }
+
+    metrics->status = system_get_status();
+    trace_get_event_counts(&metrics->trace_events, &metrics->trace_overwritten);
+    for (int point = 0; point < TRACE_POINT_COUNT; point++) {
+        trace_get_latency((trace_point_t)point, &metrics->latency[point]);
+    }
+    return 0;
+}
+
 void system_shutdown(void) {
-    printf("System shutting down...\n");
+    LOG_INFO("System shutting down...");
     memory_cleanup();
-    current_status = SYSTEM_STATUS_OK;
+    log_stop();
+    system_set_status(SYSTEM_STATUS_OK);
 }
@@ -2,6 +2,8 @@
 #define SYSTEM_H
 
 #include "config.h"
+#include "trace.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <json-c/json.h>
 
@@ -15,12 +17,52 @@ typedef enum {
     SYSTEM_STATUS_BUSY = 2
 } system_status_t;
 
-// Get system status
+// Get system status; lock-free, safe from any thread
 system_status_t system_get_status(void);
 
-// System configuration from JSON
+// Publish a new system status (release ordering)
+void system_set_status(system_status_t status);
+
+// Packed, versioned config snapshot, compiled from config/system.json at
+// build time and linked in as const data. Fields are naturally aligned, so
+// the in-memory layout is the on-disk layout (little-endian targets).
+#define SYSTEM_CONFIG_MAGIC 0x46435345u  // "ESCF"
+#define SYSTEM_CONFIG_VERSION 1
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;        // sizeof(system_config_t) when generated
+    uint8_t debug_mode;
+    uint8_t reserved[3];
+    uint32_t checksum;    // CRC-32 of the little-endian fields before it
+} system_config_t;
+
+extern const system_config_t system_config_snapshot;
+
+// Apply a snapshot (the linked-in one, or e.g. an mmap'd file) after
+// checking magic, version, size and checksum; -1 if any of them is off
+int system_load_config_snapshot(const void* data, size_t size);
+
+// System configuration from JSON; the fallback when no valid snapshot exists
 int system_load_config(struct json_object *config);
 
+// Active configuration; never NULL
+const system_config_t* system_get_config(void);
+
+// Runtime metrics: per-tracepoint latency (per message type and driver
+// operation) plus trace buffer counters. The latencies stay zero unless
+// tracepoints are compiled in (ENABLE_DEBUG).
+typedef struct {
+    system_status_t status;
+    uint64_t trace_events;       // recorded since startup
+    uint64_t trace_overwritten;  // lost to wrapped per-thread buffers
+    trace_latency_t latency[TRACE_POINT_COUNT];  // indexed by trace_point_t
+} system_metrics_t;
+
+// Snapshot the metrics; lock-free, safe from any thread
+int system_get_metrics(system_metrics_t* metrics);
+
 // System shutdown
 void system_shutdown(void);
 
@@ -0,0 +1,407 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime under strict C11
+
+#include "trace.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TRACE_USE_TSC 1
+#endif
+
+// Per-thread event ring; the oldest events are overwritten when it wraps
+#define TRACE_BUFFER_EVENTS 4096  // power of two
+
+// Log-linear histogram: values below 16 ns get exact buckets, every power
+// of two above that is split into 16 sub-buckets, up to about 2^44 ns
+#define HIST_SUB_BITS 4
+#define HIST_SUB (1u << HIST_SUB_BITS)
+#define HIST_GROUPS 41
+#define HIST_BUCKETS (HIST_GROUPS * HIST_SUB)
+
+typedef struct {
+    uint64_t start_ns;
+    uint32_t duration_ns;
+    uint32_t arg;
+    uint16_t point;
+} trace_event_t;
+
+// Written by its owner thread only (plain load + store, no RMW); readers
+// see every counter through relaxed atomic loads
+typedef struct {
+    _Atomic uint64_t count;
+    _Atomic uint64_t total_ns;
+    _Atomic uint64_t max_ns;
+    _Atomic uint64_t buckets[HIST_BUCKETS];
+} histogram_t;
+
+// A buffer's owner thread exits (RETIRED), its events are exported or
+// reset (FREE), then a new thread takes it over (ACTIVE)
+enum {
+    BUFFER_ACTIVE,
+    BUFFER_RETIRED,
+    BUFFER_EXPORTING,  // RETIRED, events written to a file not yet closed
+    BUFFER_FREE,
+};
+
+typedef struct trace_buffer {
+    struct trace_buffer* next;
+    _Atomic int state;
+    uint32_t thread_index;
+    _Atomic uint64_t head;  // events ever written
+    trace_event_t events[TRACE_BUFFER_EVENTS];
+    histogram_t hist[TRACE_POINT_COUNT];
+} trace_buffer_t;
+
+static const char* const point_names[TRACE_POINT_COUNT] = {
+    [TRACE_MEMORY_ALLOC] = "memory_alloc",
+    [TRACE_MEMORY_FREE] = "memory_free",
+    [TRACE_PROTOCOL_REQUEST] = "protocol_request",
+    [TRACE_PROTOCOL_RESPONSE] = "protocol_response",
+    [TRACE_PROTOCOL_EVENT] = "protocol_event",
+    [TRACE_PROTOCOL_OTHER] = "protocol_other",
+    [TRACE_PROTOCOL_SEND] = "protocol_send",
+    [TRACE_UART_SEND] = "uart_send",
+    [TRACE_UART_SENDV] = "uart_sendv",
+    [TRACE_SPI_TRANSFER] = "spi_transfer",
+    [TRACE_SPI_EXECUTE] = "spi_execute",
+};
+
+static const char* const point_categories[TRACE_POINT_COUNT] = {
+    [TRACE_MEMORY_ALLOC] = "memory",
+    [TRACE_MEMORY_FREE] = "memory",
+    [TRACE_PROTOCOL_REQUEST] = "protocol",
+    [TRACE_PROTOCOL_RESPONSE] = "protocol",
+    [TRACE_PROTOCOL_EVENT] = "protocol",
+    [TRACE_PROTOCOL_OTHER] = "protocol",
+    [TRACE_PROTOCOL_SEND] = "protocol",
+    [TRACE_UART_SEND] = "uart",
+    [TRACE_UART_SENDV] = "uart",
+    [TRACE_SPI_TRANSFER] = "spi",
+    [TRACE_SPI_EXECUTE] = "spi",
+};
+
+// Every buffer ever created, pushed once and never unlinked, so readers
+// walk the list without locks. Buffers whose threads have finished stay in
+// it with their histograms (metrics still include those threads) and are
+// handed to new threads once their events are exported: that list doubles
+// as the free list.
+static _Atomic(trace_buffer_t*) buffers = NULL;
+static atomic_uint next_thread_index = 0;
+static _Thread_local trace_buffer_t* local_buffer = NULL;
+
+// Events of buffers handed to a new thread, for trace_get_event_counts
+static _Atomic uint64_t reused_recorded = 0;
+static _Atomic uint64_t reused_overwritten = 0;
+
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t buffer_key;
+static bool buffer_key_valid = false;
+
+static pthread_once_t clock_once = PTHREAD_ONCE_INIT;
+static double ns_per_tick = 1.0;
+static uint64_t tick_base = 0;
+static uint64_t ns_base = 0;
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void calibrate_clock(void) {
+#ifdef TRACE_USE_TSC
+    // Spin for 2 ms against CLOCK_MONOTONIC; good to well under 0.1%
+    uint64_t ns0 = monotonic_ns();
+    uint64_t t0 = __rdtsc();
+    uint64_t ns1;
+    do {
+        ns1 = monotonic_ns();
+    } while (ns1 - ns0 < 2000000u);
+    uint64_t t1 = __rdtsc();
+
+    ns_per_tick = (double)(ns1 - ns0) / (double)(t1 - t0);
+    tick_base = t0;
+    ns_base = ns0;
+#endif
+}
+
+void trace_init(void) {
+    pthread_once(&clock_once, calibrate_clock);
+}
+
+uint64_t trace_now(void) {
+#ifdef TRACE_USE_TSC
+    return __rdtsc();
+#else
+    return monotonic_ns();
+#endif
+}
+
+static uint64_t ticks_to_ns(uint64_t ticks) {
+    return ns_base + (uint64_t)((double)(int64_t)(ticks - tick_base) * ns_per_tick);
+}
+
+static unsigned highest_bit(uint64_t v) {
+#if defined(__GNUC__)
+    return 63u - (unsigned)__builtin_clzll(v);
+#else
+    unsigned bit = 0;
+    while (v >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static unsigned hist_index(uint64_t v) {
+    if (v < HIST_SUB) {
+        return (unsigned)v;
+    }
+    unsigned e = highest_bit(v);
+    unsigned group = e - HIST_SUB_BITS + 1;
+    if (group >= HIST_GROUPS) {
+        return HIST_BUCKETS - 1;
+    }
+    return group * HIST_SUB + (unsigned)((v >> (e - HIST_SUB_BITS)) & (HIST_SUB - 1));
+}
+
+// Midpoint of a bucket's range
+static uint64_t hist_value(unsigned idx) {
+    unsigned group = idx / HIST_SUB;
+    unsigned sub = idx % HIST_SUB;
+    if (group == 0) {
+        return sub;
+    }
+    unsigned shift = group - 1;
+    return ((uint64_t)(HIST_SUB + sub) << shift) + (((uint64_t)1 << shift) >> 1);
+}
+
+static void owner_add(_Atomic uint64_t* counter, uint64_t v) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + v,
+                          memory_order_relaxed);
+}
+
+// pthread key destructor: the owner thread is exiting
+static void buffer_retire(void* arg) {
+    trace_buffer_t* buffer = arg;
+    local_buffer = NULL;
+    atomic_store_explicit(&buffer->state, BUFFER_RETIRED, memory_order_release);
+}
+
+static void create_key(void) {
+    buffer_key_valid = pthread_key_create(&buffer_key, buffer_retire) == 0;
+}
+
+static bool buffer_transition(trace_buffer_t* buffer, int from, int to) {
+    return atomic_compare_exchange_strong_explicit(&buffer->state, &from, to,
+                                                   memory_order_acq_rel, memory_order_relaxed);
+}
+
+static trace_buffer_t* buffer_reuse(void) {
+    for (trace_buffer_t* b = atomic_load_explicit(&buffers, memory_order_acquire); b != NULL; b = b->next) {
+        if (buffer_transition(b, BUFFER_FREE, BUFFER_ACTIVE)) {
+            // The events were exported; the histograms keep counting
+            uint64_t head = atomic_load_explicit(&b->head, memory_order_relaxed);
+            atomic_fetch_add_explicit(&reused_recorded, head, memory_order_relaxed);
+            if (head > TRACE_BUFFER_EVENTS) {
+                atomic_fetch_add_explicit(&reused_overwritten, head - TRACE_BUFFER_EVENTS,
+                                          memory_order_relaxed);
+            }
+            atomic_store_explicit(&b->head, 0, memory_order_relaxed);
+            return b;
+        }
+    }
+    return NULL;
+}
+
+static trace_buffer_t* buffer_create(void) {
+    pthread_once(&key_once, create_key);
+
+    trace_buffer_t* buffer = buffer_reuse();
+    if (buffer == NULL) {
+        // Plain calloc: the pool allocator is itself traced
+        buffer = calloc(1, sizeof(*buffer));
+        if (buffer == NULL) {
+            return NULL;
+        }
+        trace_buffer_t* head = atomic_load_explicit(&buffers, memory_order_relaxed);
+        do {
+            buffer->next = head;
+        } while (!atomic_compare_exchange_weak_explicit(&buffers, &head, buffer,
+                                                        memory_order_release, memory_order_relaxed));
+    }
+    buffer->thread_index = atomic_fetch_add(&next_thread_index, 1);
+
+    if (buffer_key_valid) {
+        pthread_setspecific(buffer_key, buffer);
+    }
+    local_buffer = buffer;
+    return buffer;
+}
+
+void trace_record_ns(trace_point_t point, uint64_t start_ns, uint64_t duration_ns, uint32_t arg) {
+    if ((unsigned)point >= TRACE_POINT_COUNT) {
+        return;
+    }
+    trace_buffer_t* buffer = local_buffer != NULL ? local_buffer : buffer_create();
+    if (buffer == NULL) {
+        return;
+    }
+
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    trace_event_t* event = &buffer->events[head & (TRACE_BUFFER_EVENTS - 1)];
+    event->start_ns = start_ns;
+    event->duration_ns = duration_ns > UINT32_MAX ? UINT32_MAX : (uint32_t)duration_ns;
+    event->arg = arg;
+    event->point = (uint16_t)point;
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+
+    histogram_t* hist = &buffer->hist[point];
+    owner_add(&hist->count, 1);
+    owner_add(&hist->total_ns, duration_ns);
+    owner_add(&hist->buckets[hist_index(duration_ns)], 1);
+    if (duration_ns > atomic_load_explicit(&hist->max_ns, memory_order_relaxed)) {
+        atomic_store_explicit(&hist->max_ns, duration_ns, memory_order_relaxed);
+    }
+}
+
+void trace_record(trace_point_t point, uint64_t start, uint64_t end, uint32_t arg) {
+    trace_init();
+    uint64_t start_ns = ticks_to_ns(start);
+    uint64_t end_ns = ticks_to_ns(end);
+    trace_record_ns(point, start_ns, end_ns > start_ns ? end_ns - start_ns : 0, arg);
+}
+
+const char* trace_point_name(trace_point_t point) {
+    return (unsigned)point < TRACE_POINT_COUNT ? point_names[point] : "unknown";
+}
+
+static uint64_t percentile(const uint64_t* buckets, uint64_t count, uint64_t max_ns, double p) {
+    uint64_t rank = (uint64_t)(p * (double)count + 0.999999);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < HIST_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint64_t v = hist_value(i);
+            return v < max_ns ? v : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+int trace_get_latency(trace_point_t point, trace_latency_t* latency) {
+    if (latency == NULL || (unsigned)point >= TRACE_POINT_COUNT) {
+        return -1;
+    }
+
+    uint64_t buckets[HIST_BUCKETS] = {0};
+    *latency = (trace_latency_t){0};
+    for (trace_buffer_t* b = atomic_load_explicit(&buffers, memory_order_acquire); b != NULL; b = b->next) {
+        histogram_t* hist = &b->hist[point];
+        latency->count += atomic_load_explicit(&hist->count, memory_order_relaxed);
+        latency->total_ns += atomic_load_explicit(&hist->total_ns, memory_order_relaxed);
+        uint64_t max_ns = atomic_load_explicit(&hist->max_ns, memory_order_relaxed);
+        if (max_ns > latency->max_ns) {
+            latency->max_ns = max_ns;
+        }
+        for (unsigned i = 0; i < HIST_BUCKETS; i++) {
+            buckets[i] += atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+        }
+    }
+
+    if (latency->count > 0) {
+        // Recount from the buckets so the ranks match what was summed
+        uint64_t total = 0;
+        for (unsigned i = 0; i < HIST_BUCKETS; i++) {
+            total += buckets[i];
+        }
+        latency->p50_ns = percentile(buckets, total, latency->max_ns, 0.50);
+        latency->p90_ns = percentile(buckets, total, latency->max_ns, 0.90);
+        latency->p99_ns = percentile(buckets, total, latency->max_ns, 0.99);
+        latency->p999_ns = percentile(buckets, total, latency->max_ns, 0.999);
+    }
+    return 0;
+}
+
+void trace_get_event_counts(uint64_t* recorded, uint64_t* overwritten) {
+    uint64_t total = atomic_load_explicit(&reused_recorded, memory_order_relaxed);
+    uint64_t lost = atomic_load_explicit(&reused_overwritten, memory_order_relaxed);
+    for (trace_buffer_t* b = atomic_load_explicit(&buffers, memory_order_acquire); b != NULL; b = b->next) {
+        uint64_t head = atomic_load_explicit(&b->head, memory_order_acquire);
+        total += head;
+        if (head > TRACE_BUFFER_EVENTS) {
+            lost += head - TRACE_BUFFER_EVENTS;
+        }
+    }
+    if (recorded != NULL) {
+        *recorded = total;
+    }
+    if (overwritten != NULL) {
+        *overwritten = lost;
+    }
+}
+
+long trace_export_chrome(const char* path) {
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        return -1;
+    }
+
+    long written = 0;
+    bool first = true;
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (trace_buffer_t* b = atomic_load_explicit(&buffers, memory_order_acquire); b != NULL; b = b->next) {
+        // Claimed before reading, so a thread exiting mid-export keeps its buffer
+        buffer_transition(b, BUFFER_RETIRED, BUFFER_EXPORTING);
+        fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"name\":\"thread %u\"}}",
+                first ? "" : ",", b->thread_index, b->thread_index);
+        first = false;
+
+        uint64_t head = atomic_load_explicit(&b->head, memory_order_acquire);
+        uint64_t begin = head > TRACE_BUFFER_EVENTS ? head - TRACE_BUFFER_EVENTS : 0;
+        for (uint64_t i = begin; i < head; i++) {
+            const trace_event_t* e = &b->events[i & (TRACE_BUFFER_EVENTS - 1)];
+            // Complete ("X") events; Chrome trace timestamps are in microseconds
+            fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,"
+                    "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"arg\":%u}}",
+                    point_names[e->point], point_categories[e->point], b->thread_index,
+                    (double)e->start_ns / 1000.0, (double)e->duration_ns / 1000.0, e->arg);
+            written++;
+        }
+    }
+    fprintf(out, "\n]}\n");
+
+    bool exported = fclose(out) == 0;
+    for (trace_buffer_t* b = atomic_load_explicit(&buffers, memory_order_acquire); b != NULL; b = b->next) {
+        buffer_transition(b, BUFFER_EXPORTING, exported ? BUFFER_FREE : BUFFER_RETIRED);
+    }
+    return exported ? written : -1;
+}
+
+void trace_reset(void) {
+    atomic_store_explicit(&reused_recorded, 0, memory_order_relaxed);
+    atomic_store_explicit(&reused_overwritten, 0, memory_order_relaxed);
+    for (trace_buffer_t* b = atomic_load_explicit(&buffers, memory_order_acquire); b != NULL; b = b->next) {
+        buffer_transition(b, BUFFER_RETIRED, BUFFER_FREE);
+        atomic_store_explicit(&b->head, 0, memory_order_relaxed);
+        for (int p = 0; p < TRACE_POINT_COUNT; p++) {
+            histogram_t* hist = &b->hist[p];
+            atomic_store_explicit(&hist->count, 0, memory_order_relaxed);
+            atomic_store_explicit(&hist->total_ns, 0, memory_order_relaxed);
+            atomic_store_explicit(&hist->max_ns, 0, memory_order_relaxed);
+            for (unsigned i = 0; i < HIST_BUCKETS; i++) {
+                atomic_store_explicit(&hist->buckets[i], 0, memory_order_relaxed);
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Static tracepoints on the hot paths. Each one feeds a per-thread event
+// buffer (for trace export) and a per-thread latency histogram (for
+// metrics); nothing is shared between threads on the record path.
+typedef enum {
+    TRACE_MEMORY_ALLOC = 0,
+    TRACE_MEMORY_FREE,
+    TRACE_PROTOCOL_REQUEST,   // protocol_handle_message, per message type
+    TRACE_PROTOCOL_RESPONSE,
+    TRACE_PROTOCOL_EVENT,
+    TRACE_PROTOCOL_OTHER,     // any other type, including unknown ones
+    TRACE_PROTOCOL_SEND,
+    TRACE_UART_SEND,
+    TRACE_UART_SENDV,
+    TRACE_SPI_TRANSFER,
+    TRACE_SPI_EXECUTE,
+    TRACE_POINT_COUNT
+} trace_point_t;
+
+// TRACE_BEGIN/TRACE_END bracket a traced section. They compile to nothing
+// unless ENABLE_DEBUG is set (debug builds), so release hot paths carry no
+// trace code at all.
+#ifdef ENABLE_DEBUG
+#define TRACE_BEGIN(var) uint64_t var = trace_now()
+#define TRACE_END(point, var, arg) trace_record((point), (var), trace_now(), (uint32_t)(arg))
+#else
+#define TRACE_BEGIN(var) ((void)0)
+#define TRACE_END(point, var, arg) ((void)0)
+#endif
+
+// Calibrate the clock; called by system_init(), later calls are no-ops
+void trace_init(void);
+
+// Raw timestamp: the TSC on x86 (calibrated against CLOCK_MONOTONIC at
+// init, so an invariant TSC is assumed), CLOCK_MONOTONIC ns elsewhere
+uint64_t trace_now(void);
+
+// Record a section between two trace_now() readings; arg is free-form
+// (sizes, ids) and shows up in the exported trace
+void trace_record(trace_point_t point, uint64_t start, uint64_t end, uint32_t arg);
+
+// Same, with the start already in ns of CLOCK_MONOTONIC
+void trace_record_ns(trace_point_t point, uint64_t start_ns, uint64_t duration_ns, uint32_t arg);
+
+const char* trace_point_name(trace_point_t point);
+
+// Latency summary for one tracepoint, merged over all threads. The
+// histogram is log-linear (HDR style, 16 sub-buckets per power of two), so
+// percentiles are within about 6% of the true value.
+typedef struct {
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+} trace_latency_t;
+
+int trace_get_latency(trace_point_t point, trace_latency_t* latency);
+
+// Events recorded since startup, and how many of them were overwritten
+// because a thread's buffer wrapped before export
+void trace_get_event_counts(uint64_t* recorded, uint64_t* overwritten);
+
+// Write the buffered events as Chrome trace JSON (chrome://tracing,
+// ui.perfetto.dev). Event buffers are read without locks: export once the
+// traced threads are idle. Returns the number of events written, -1 on error.
+// Once exported, the buffers of threads that have exited go to new threads
+// instead of new allocations.
+long trace_export_chrome(const char* path);
+
+// Clear every histogram and event buffer
+void trace_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,86 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace drivers {
+
+// Lock-free single-producer/single-consumer byte ring. The producer is the
+// RX interrupt or DMA-complete handler, the consumer is the reading thread.
+// Indices run freely and are masked on access, so full and empty differ.
+template <size_t Capacity>
+class RingBuffer {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "RingBuffer capacity must be a power of two");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Producer: copy in as many bytes as fit, return how many were taken
+    size_t write(const uint8_t* data, size_t length) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t count = std::min(length, Capacity - (head - tail));
+
+        size_t index = head & (Capacity - 1);
+        size_t first = std::min(count, Capacity - index);
+        std::memcpy(&buffer_[index], data, first);
+        std::memcpy(&buffer_[0], data + first, count - first);
+
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: hand out up to max_length bytes as at most two contiguous
+    // chunks straight from the ring, then release them
+    template <typename Consumer>
+    size_t consume(Consumer&& consumer, size_t max_length = SIZE_MAX) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t count = std::min(head - tail, max_length);
+        if (count == 0) {
+            return 0;
+        }
+
+        size_t index = tail & (Capacity - 1);
+        size_t first = std::min(count, Capacity - index);
+        consumer(&buffer_[index], first);
+        if (count > first) {
+            consumer(&buffer_[0], count - first);
+        }
+
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer: bulk copy out
+    size_t read(uint8_t* out, size_t max_length) {
+        size_t copied = 0;
+        return consume([&](const uint8_t* chunk, size_t length) {
+            std::memcpy(out + copied, chunk, length);
+            copied += length;
+        }, max_length);
+    }
+
+    size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    uint8_t buffer_[Capacity];
+};
+
+} // namespace drivers
+
+#endif // RING_BUFFER_HPP
@@ -1,15 +1,19 @@
 #include "spi.hpp"
-#include <iostream>
+
+extern "C" {
+    #include "core/log.h"
+    #include "core/trace.h"
+}
 
 namespace drivers {
 
 SPI::SPI(uint32_t clock_speed, SPIMode mode)
-    : clock_speed_(clock_speed), mode_(mode), initialized_(false), cs_active_(false) {
+    : clock_speed_(clock_speed), mode_(mode), initialized_(false), cs_active_(false), shift_reg_(0) {
 }
 
 SPI::~SPI() {
-    if (initialized_) {
-        std::cout << "SPI closed" << std::endl;
+    if (ready()) {
+        LOG_INFO("SPI closed");
     }
 }
 
@@ -19,28 +23,121 @@ bool SPI::init() {
         return false;
     }
 
-    std::cout << "SPI initialized at " << clock_speed_ << " Hz, mode "
-              << static_cast<int>(mode_) << std::endl;
-    initialized_ = true;
+    LOG_INFO("SPI initialized at %u Hz, mode %d",
+             static_cast<unsigned>(clock_speed_), static_cast<int>(mode_));
+    initialized_.store(true, std::memory_order_release);
     return true;
 }
 
 std::vector<uint8_t> SPI::transfer(const std::vector<uint8_t>& tx_data) {
-    if (!initialized_) {
+    if (!ready()) {
         return std::vector<uint8_t>();
     }
 
-    // Simulate full-duplex transfer
-    std::vector<uint8_t> rx_data(tx_data.size(), 0xFF);
+    std::vector<uint8_t> rx_data(tx_data.size());
+    transfer(tx_data.data(), rx_data.data(), tx_data.size());
+    return rx_data;
+}
 
-    std::cout << "SPI transfer: " << tx_data.size() << " bytes" << std::endl;
+int SPI::transfer(const uint8_t* tx, uint8_t* rx, size_t length) {
+    if (!ready()) {
+        return -1;
+    }
 
-    return rx_data;
+    LOG_DEBUG("SPI transfer: %zu bytes", length);
+
+    TRACE_BEGIN(start);
+    shift(tx, rx, length);
+    TRACE_END(TRACE_SPI_TRANSFER, start, length);
+    return static_cast<int>(length);
+}
+
+int SPI::transfer(uint8_t* data, size_t length) {
+    // Each tx byte is read before its rx byte is stored, so aliasing is safe
+    return transfer(data, data, length);
 }
 
 void SPI::set_cs(bool active) {
-    cs_active_ = active;
-    std::cout << "SPI CS: " << (active ? "active" : "inactive") << std::endl;
+    cs_active_.store(active, std::memory_order_release);
+    LOG_DEBUG("SPI CS: %s", active ? "active" : "inactive");
+}
+
+void SPI::queue(Transaction transaction) {
+    queue_.push_back(std::move(transaction));
+}
+
+size_t SPI::execute() {
+    if (!ready() || queue_.empty()) {
+        return 0;
+    }
+
+    TRACE_BEGIN(start);
+    size_t completed = 0;
+    size_t bytes = 0;
+    // Callbacks may queue follow-ups; they land in queue_, not in this batch
+    std::vector<Transaction> batch;
+    batch.swap(queue_);
+    for (const Transaction& t : batch) {
+        SPIMode mode = t.mode.value_or(mode_);
+        uint32_t clock = t.clock_speed ? t.clock_speed : clock_speed_;
+        if (bus_shift_ != nullptr && (mode != mode_ || clock != clock_speed_)) {
+            // A fixed-configuration bus cannot be reprogrammed. End any
+            // chain held by keep_cs so the next bytes start a new one.
+            cs_active_.store(false, std::memory_order_release);
+            if (t.on_complete) {
+                t.on_complete(t, -1);
+            }
+            continue;
+        }
+        if (mode != mode_ || clock != clock_speed_) {
+            // Mode changes are only legal with the device deselected
+            cs_active_.store(false, std::memory_order_release);
+            configure(mode, clock);
+        }
+
+        cs_active_.store(true, std::memory_order_release);
+        shift(t.tx, t.rx, t.length);
+        if (!t.keep_cs) {
+            cs_active_.store(false, std::memory_order_release);
+        }
+
+        bytes += t.length;
+        ++completed;
+        if (t.on_complete) {
+            t.on_complete(t, static_cast<int>(t.length));
+        }
+    }
+    cs_active_.store(false, std::memory_order_release);
+    if (queue_.empty()) {
+        // Keep the allocation for the next batch
+        batch.clear();
+        queue_.swap(batch);
+    }
+    TRACE_END(TRACE_SPI_EXECUTE, start, completed);
+
+    LOG_DEBUG("SPI executed %zu transactions, %zu bytes", completed, bytes);
+    return completed;
+}
+
+void SPI::shift(const uint8_t* tx, uint8_t* rx, size_t length) {
+    if (bus_shift_ != nullptr) {
+        bus_shift_(bus_device_, tx, rx, length);
+        return;
+    }
+
+    // Simulate full-duplex transfer: one shift per byte, the bus idles high
+    for (size_t i = 0; i < length; ++i) {
+        shift_reg_ = tx ? tx[i] : 0xFF;
+        shift_reg_ = 0xFF;
+        if (rx) {
+            rx[i] = shift_reg_;
+        }
+    }
+}
+
+void SPI::configure(SPIMode mode, uint32_t clock_speed) {
+    mode_ = mode;
+    clock_speed_ = clock_speed;
 }
 
 } // namespace drivers
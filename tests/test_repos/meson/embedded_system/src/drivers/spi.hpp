@@ -1,8 +1,13 @@
 #ifndef SPI_HPP
 #define SPI_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <optional>
 #include <vector>
+#include "spi_fixed.hpp"
 
 extern "C" {
     #include "core/system.h"
@@ -10,16 +15,33 @@ extern "C" {
 
 namespace drivers {
 
-enum class SPIMode {
-    MODE_0 = 0,
-    MODE_1 = 1,
-    MODE_2 = 2,
-    MODE_3 = 3
-};
-
 class SPI {
 public:
+    // One chip-select framed transfer. CS is asserted before and released
+    // after unless keep_cs is set, which chains it into the next transaction.
+    struct Transaction {
+        const uint8_t* tx = nullptr;
+        uint8_t* rx = nullptr;
+        size_t length = 0;
+        std::optional<SPIMode> mode;  // empty keeps the current mode
+        uint32_t clock_speed = 0;     // 0 keeps the current clock
+        bool keep_cs = false;
+        std::function<void(const Transaction&, int)> on_complete;
+    };
+
     SPI(uint32_t clock_speed, SPIMode mode);
+
+    // Type-erased view of a fixed-configuration bus: shifts go to the
+    // device, and queued transactions asking for another mode or clock
+    // fail with -1 instead of reconfiguring it
+    template <uint32_t Clock, SPIMode Mode, typename Policy>
+    explicit SPI(fixed::SPI<Clock, Mode, Policy>& device) : SPI(Clock, Mode) {
+        bus_device_ = &device;
+        bus_shift_ = [](void* bus, const uint8_t* tx, uint8_t* rx, size_t length) {
+            static_cast<fixed::SPI<Clock, Mode, Policy>*>(bus)->shift(tx, rx, length);
+        };
+    }
+
     ~SPI();
 
     // Initialize SPI
@@ -28,14 +50,46 @@ public:
     // Transfer data (full duplex)
     std::vector<uint8_t> transfer(const std::vector<uint8_t>& tx_data);
 
+    // Full-duplex transfer into a caller-owned buffer; no allocation.
+    // tx may be null to clock out idle bytes (0xFF), rx may be null to
+    // discard what comes back. Returns bytes transferred, -1 if not ready.
+    int transfer(const uint8_t* tx, uint8_t* rx, size_t length);
+
+    // In-place transfer: sends `data` and overwrites it with the received bytes
+    int transfer(uint8_t* data, size_t length);
+
     // Set chip select
     void set_cs(bool active);
 
+    // Queue a transaction for the next execute()
+    void queue(Transaction transaction);
+
+    // Run queued transactions back-to-back, reconfiguring mode and clock
+    // only when they change. Returns the number of transactions completed.
+    // Transactions queued from a completion callback run on the next call.
+    size_t execute();
+
+    size_t pending() const { return queue_.size(); }
+    bool cs_active() const { return cs_active_.load(std::memory_order_acquire); }
+    SPIMode mode() const { return mode_; }
+    uint32_t clock_speed() const { return clock_speed_; }
+
 private:
+    void shift(const uint8_t* tx, uint8_t* rx, size_t length);
+    void configure(SPIMode mode, uint32_t clock_speed);
+
+    bool ready() const { return initialized_.load(std::memory_order_acquire); }
+
     uint32_t clock_speed_;
     SPIMode mode_;
-    bool initialized_;
-    bool cs_active_;
+    // Set when wrapping a fixed::SPI
+    void* bus_device_ = nullptr;
+    void (*bus_shift_)(void* device, const uint8_t* tx, uint8_t* rx, size_t length) = nullptr;
+    // Shared flags on their own cache lines, away from the transfer state
+    alignas(64) std::atomic<bool> initialized_;
+    alignas(64) std::atomic<bool> cs_active_;
+    volatile uint8_t shift_reg_;
+    std::vector<Transaction> queue_;
 };
 
 } // namespace drivers
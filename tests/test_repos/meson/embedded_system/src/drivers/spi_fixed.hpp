@@ -0,0 +1,116 @@
+#ifndef SPI_FIXED_HPP
+#define SPI_FIXED_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" {
+    #include "core/log.h"
+    #include "core/system.h"
+    #include "core/trace.h"
+}
+
+namespace drivers {
+
+enum class SPIMode {
+    MODE_0 = 0,
+    MODE_1 = 1,
+    MODE_2 = 2,
+    MODE_3 = 3
+};
+
+// SCK is the peripheral clock over a power-of-two prescaler (2..256); pick
+// the smallest one that does not exceed the requested clock. Returns 0 when
+// even /256 is too fast.
+constexpr uint32_t spi_prescaler(uint32_t clock_hz, uint32_t sck_hz) {
+    if (sck_hz == 0) {
+        return 0;
+    }
+    for (uint32_t prescaler = 2; prescaler <= 256; prescaler *= 2) {
+        if (clock_hz / prescaler <= sck_hz) {
+            return prescaler;
+        }
+    }
+    return 0;
+}
+
+struct SPIDefaultPolicy {
+    static constexpr uint32_t kPeripheralClockHz = 64000000;
+    static constexpr uint8_t kIdleByte = 0xFF;  // MOSI idles high
+};
+
+namespace fixed {
+
+// Header-only SPI master with the clock and mode fixed at build time. The
+// prescaler, clock polarity/phase and bit timing are compile-time constants
+// and transfers skip the initialized check: call init() once at bring-up.
+// drivers::SPI can wrap one of these for code that takes a runtime SPI.
+template <uint32_t Clock, SPIMode Mode = SPIMode::MODE_0, typename Policy = SPIDefaultPolicy>
+class SPI {
+public:
+    static constexpr uint32_t kClockSpeed = Clock;
+    static constexpr SPIMode kMode = Mode;
+    static constexpr uint32_t kPrescaler = spi_prescaler(Policy::kPeripheralClockHz, Clock);
+    static_assert(kPrescaler != 0, "SPI clock is out of range for the peripheral clock");
+
+    static constexpr uint32_t kActualClockHz = Policy::kPeripheralClockHz / (kPrescaler ? kPrescaler : 1);
+    static constexpr uint32_t kBitTimeNs = (1000000000u + kActualClockHz - 1) / kActualClockHz;
+    static constexpr bool kCPOL = Mode == SPIMode::MODE_2 || Mode == SPIMode::MODE_3;
+    static constexpr bool kCPHA = Mode == SPIMode::MODE_1 || Mode == SPIMode::MODE_3;
+
+    SPI() = default;
+
+    bool init() {
+        if (system_get_status() != SYSTEM_STATUS_OK) {
+            return false;
+        }
+        LOG_INFO("SPI initialized at %u Hz (prescaler %u), mode %d",
+                 static_cast<unsigned>(kActualClockHz), static_cast<unsigned>(kPrescaler),
+                 static_cast<int>(Mode));
+        return true;
+    }
+
+    // Full duplex, same contract as drivers::SPI::transfer: tx may be null
+    // to clock out idle bytes, rx may be null to discard what comes back
+    int transfer(const uint8_t* tx, uint8_t* rx, size_t length) {
+        TRACE_BEGIN(start);
+        shift(tx, rx, length);
+        TRACE_END(TRACE_SPI_TRANSFER, start, length);
+        return static_cast<int>(length);
+    }
+
+    // In-place: each tx byte is read before its rx byte is stored
+    int transfer(uint8_t* data, size_t length) {
+        return transfer(data, data, length);
+    }
+
+    void set_cs(bool active) {
+        cs_active_.store(active, std::memory_order_release);
+    }
+
+    bool cs_active() const {
+        return cs_active_.load(std::memory_order_acquire);
+    }
+
+    // Clock bytes through the shift register, untraced
+    void shift(const uint8_t* tx, uint8_t* rx, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            shift_reg_ = tx ? tx[i] : Policy::kIdleByte;
+            shift_reg_ = Policy::kIdleByte;
+            if (rx) {
+                rx[i] = shift_reg_;
+            }
+        }
+    }
+
+private:
+    std::atomic<bool> cs_active_{false};
+    volatile uint8_t shift_reg_ = 0;
+};
+
+} // namespace fixed
+
+} // namespace drivers
+
+#endif // SPI_FIXED_HPP
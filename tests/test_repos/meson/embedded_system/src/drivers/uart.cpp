@@ -1,16 +1,22 @@
 #include "uart.hpp"
-#include <iostream>
 #include <cstring>
 
+extern "C" {
+    #include "core/log.h"
+    #include "core/trace.h"
+}
+
 namespace drivers {
 
 UART::UART(uint32_t baud_rate)
-    : baud_rate_(baud_rate), initialized_(false) {
+    : baud_rate_(baud_rate),
+      divisor_(uart_divisor(UARTDefaultPolicy::kPeripheralClockHz, UARTDefaultPolicy::kOversampling, baud_rate)),
+      initialized_(false), tx_data_(0), rx_overruns_(0) {
 }
 
 UART::~UART() {
-    if (initialized_) {
-        std::cout << "UART closed" << std::endl;
+    if (ready()) {
+        LOG_INFO("UART closed");
     }
 }
 
@@ -19,37 +25,112 @@ bool UART::init() {
     if (system_get_status() != SYSTEM_STATUS_OK) {
         return false;
     }
+    if (divisor_ == 0) {
+        LOG_ERROR("UART baud rate %u out of range", static_cast<unsigned>(baud_rate_));
+        return false;
+    }
 
-    std::cout << "UART initialized at " << baud_rate_ << " baud" << std::endl;
-    initialized_ = true;
+    LOG_INFO("UART initialized at %u baud", static_cast<unsigned>(baud_rate_));
+    initialized_.store(true, std::memory_order_release);
     return true;
 }
 
 int UART::send(const uint8_t* data, size_t length) {
-    if (!initialized_) {
+    if (!ready()) {
         return -1;
     }
 
     // Simulate sending data
-    std::cout << "UART sending " << length << " bytes" << std::endl;
+    LOG_DEBUG("UART sending %zu bytes", length);
+    TRACE_BEGIN(start);
+    transmit(data, length);
+    TRACE_END(TRACE_UART_SEND, start, length);
     return static_cast<int>(length);
 }
 
+int UART::sendv(const IoVec* buffers, size_t count) {
+    if (!ready()) {
+        return -1;
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += buffers[i].length;
+    }
+
+    // One logical write: the chunks go out in order straight from their owners
+    LOG_DEBUG("UART sending %zu bytes from %zu buffers", total, count);
+    TRACE_BEGIN(start);
+    for (size_t i = 0; i < count; ++i) {
+        transmit(buffers[i].data, buffers[i].length);
+    }
+    TRACE_END(TRACE_UART_SENDV, start, total);
+    return static_cast<int>(total);
+}
+
+int UART::sendv(std::initializer_list<IoVec> buffers) {
+    return sendv(buffers.begin(), buffers.size());
+}
+
 int UART::receive(uint8_t* buffer, size_t max_length) {
-    if (!initialized_) {
+    return read_some(buffer, max_length);
+}
+
+size_t UART::available() const {
+    return rx_ring_.size();
+}
+
+int UART::read_some(uint8_t* buffer, size_t max_length) {
+    if (!ready()) {
         return -1;
     }
 
-    // Simulate receiving data
-    size_t received = max_length > 0 ? 1 : 0;
-    if (received > 0) {
-        buffer[0] = 0x42;  // Dummy data
+    return static_cast<int>(rx_ring_.read(buffer, max_length));
+}
+
+int UART::read_some(uint8_t* buffer, size_t max_length, std::chrono::milliseconds timeout) {
+    if (!ready()) {
+        return -1;
     }
-    return static_cast<int>(received);
+
+    if (rx_ring_.empty()) {
+        std::unique_lock<std::mutex> lock(rx_mutex_);
+        rx_ready_.wait_for(lock, timeout, [this] { return !rx_ring_.empty(); });
+    }
+    return static_cast<int>(rx_ring_.read(buffer, max_length));
 }
 
-int UART::send_string(const std::string& str) {
-    return send(reinterpret_cast<const uint8_t*>(str.c_str()), str.length());
+size_t UART::on_rx_interrupt(const uint8_t* data, size_t length) {
+    size_t queued = rx_ring_.write(data, length);
+    if (queued < length) {
+        rx_overruns_.fetch_add(length - queued, std::memory_order_relaxed);
+    }
+
+    // On hardware this is a semaphore give from the ISR; in host simulation
+    // the empty critical section orders the wakeup after the waiter's check
+    { std::lock_guard<std::mutex> lock(rx_mutex_); }
+    rx_ready_.notify_one();
+    return queued;
+}
+
+size_t UART::rx_overruns() const {
+    return rx_overruns_.load(std::memory_order_relaxed);
+}
+
+int UART::send_string(std::string_view str) {
+    return send(reinterpret_cast<const uint8_t*>(str.data()), str.length());
+}
+
+void UART::transmit(const uint8_t* data, size_t length) {
+    if (tx_write_ != nullptr) {
+        tx_write_(tx_device_, data, length);
+        return;
+    }
+
+    // Simulated TX register: one volatile store per byte, like the real FIFO
+    for (size_t i = 0; i < length; ++i) {
+        tx_data_ = data[i];
+    }
 }
 
 } // namespace drivers
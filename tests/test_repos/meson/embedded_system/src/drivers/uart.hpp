@@ -1,8 +1,16 @@
 #ifndef UART_HPP
 #define UART_HPP
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
-#include <string>
+#include <initializer_list>
+#include <mutex>
+#include <string_view>
+#include "ring_buffer.hpp"
+#include "uart_fixed.hpp"
 
 extern "C" {
     #include "core/system.h"
@@ -13,6 +21,18 @@ namespace drivers {
 class UART {
 public:
     UART(uint32_t baud_rate);
+
+    // Type-erased view of a fixed-configuration port: transmits go to the
+    // device, everything else (RX ring, blocking reads) stays in the wrapper
+    template <uint32_t Baud, typename Policy>
+    explicit UART(fixed::UART<Baud, Policy>& device) : UART(Baud) {
+        divisor_ = fixed::UART<Baud, Policy>::kDivisor;
+        tx_device_ = &device;
+        tx_write_ = [](void* port, const uint8_t* data, size_t length) {
+            static_cast<fixed::UART<Baud, Policy>*>(port)->transmit(data, length);
+        };
+    }
+
     ~UART();
 
     // Initialize UART
@@ -21,15 +41,63 @@ public:
     // Send data
     int send(const uint8_t* data, size_t length);
 
-    // Receive data
+    // Receive data: drains whatever the RX ring holds, up to max_length
     int receive(uint8_t* buffer, size_t max_length);
 
-    // Send string
-    int send_string(const std::string& str);
+    // Bytes waiting in the RX ring
+    size_t available() const;
+
+    // Non-blocking bulk read; returns 0 when nothing has arrived
+    int read_some(uint8_t* buffer, size_t max_length);
+
+    // Wait up to `timeout` for data, then read what has arrived
+    int read_some(uint8_t* buffer, size_t max_length, std::chrono::milliseconds timeout);
+
+    // Hand buffered bytes to `consumer(const uint8_t*, size_t)` in place,
+    // as at most two contiguous chunks, without copying them out first
+    template <typename Consumer>
+    size_t drain(Consumer&& consumer) {
+        return ready() ? rx_ring_.consume(std::forward<Consumer>(consumer)) : 0;
+    }
+
+    // RX interrupt / DMA-complete entry point: queue received bytes.
+    // Bytes that do not fit are dropped and counted as overruns.
+    size_t on_rx_interrupt(const uint8_t* data, size_t length);
+    size_t rx_overruns() const;
+
+    // Send several buffers back to back without joining them first
+    int sendv(const IoVec* buffers, size_t count);
+    int sendv(std::initializer_list<IoVec> buffers);
+
+    // Send string (std::string and string literals convert without copying)
+    int send_string(std::string_view str);
+
+    uint32_t baud_rate() const { return baud_rate_; }
+
+    // Baud rate divisor for the default board clock; 0 if out of range
+    uint32_t divisor() const { return divisor_; }
 
 private:
+    // Push bytes into the transmit data register
+    void transmit(const uint8_t* data, size_t length);
+
+    static constexpr size_t kRxBufferSize = 1024;
+
+    bool ready() const { return initialized_.load(std::memory_order_acquire); }
+
     uint32_t baud_rate_;
-    bool initialized_;
+    uint32_t divisor_;
+    // Set when wrapping a fixed::UART
+    void* tx_device_ = nullptr;
+    void (*tx_write_)(void* device, const uint8_t* data, size_t length) = nullptr;
+    // Read on every call from any thread; kept off the lines written per byte
+    alignas(64) std::atomic<bool> initialized_;
+    volatile uint8_t tx_data_;
+
+    RingBuffer<kRxBufferSize> rx_ring_;
+    std::atomic<size_t> rx_overruns_;
+    std::mutex rx_mutex_;
+    std::condition_variable rx_ready_;
 };
 
 } // namespace drivers
@@ -0,0 +1,152 @@
+#ifndef UART_FIXED_HPP
+#define UART_FIXED_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <utility>
+#include "ring_buffer.hpp"
+
+extern "C" {
+    #include "core/log.h"
+    #include "core/system.h"
+    #include "core/trace.h"
+}
+
+namespace drivers {
+
+// Non-owning view of one contiguous chunk of a gathered write (like iovec)
+struct IoVec {
+    const uint8_t* data;
+    size_t length;
+};
+
+// Baud rate generator: the peripheral clock is divided by oversampling *
+// divisor. Returns 0 when the rate cannot be reached with a 16-bit divisor.
+constexpr uint32_t uart_divisor(uint32_t clock_hz, uint32_t oversampling, uint32_t baud_rate) {
+    if (baud_rate == 0 || oversampling == 0) {
+        return 0;
+    }
+    uint64_t step = uint64_t(baud_rate) * oversampling;
+    uint64_t divisor = (clock_hz + step / 2) / step;
+    return divisor >= 1 && divisor <= 0xFFFF ? static_cast<uint32_t>(divisor) : 0;
+}
+
+// Default board: the classic 14.7456 MHz UART crystal, 16x oversampling,
+// which divides exactly down to every standard rate up to 921600
+struct UARTDefaultPolicy {
+    static constexpr uint32_t kPeripheralClockHz = 14745600;
+    static constexpr uint32_t kOversampling = 16;
+    static constexpr uint32_t kFrameBits = 10;  // start + 8 data + stop
+    static constexpr size_t kRxBufferSize = 1024;
+};
+
+namespace fixed {
+
+// Header-only UART for boards whose port configuration is known at build
+// time. Baud rate, divisor and frame timing are compile-time constants and
+// the I/O calls skip the initialized check: call init() once at bring-up.
+// drivers::UART can wrap one of these for code that takes a runtime UART.
+template <uint32_t Baud, typename Policy = UARTDefaultPolicy>
+class UART {
+public:
+    static constexpr uint32_t kBaudRate = Baud;
+    static constexpr uint32_t kDivisor =
+        uart_divisor(Policy::kPeripheralClockHz, Policy::kOversampling, Baud);
+    static_assert(kDivisor != 0, "baud rate is out of range for the peripheral clock");
+
+    static constexpr uint32_t kActualBaudRate =
+        Policy::kPeripheralClockHz / (Policy::kOversampling * (kDivisor ? kDivisor : 1));
+    // Receivers tolerate a few percent of clock mismatch, not more
+    static_assert(uint64_t(kActualBaudRate > Baud ? kActualBaudRate - Baud : Baud - kActualBaudRate) * 100
+                      <= uint64_t(Baud) * 3,
+                  "baud rate error exceeds 3% with this peripheral clock");
+
+    static constexpr uint32_t kByteTimeNs =
+        static_cast<uint32_t>(uint64_t(Policy::kFrameBits) * 1000000000u / kActualBaudRate);
+
+    UART() = default;
+
+    // Check the system is up; the port itself needs no runtime setup
+    bool init() {
+        if (system_get_status() != SYSTEM_STATUS_OK) {
+            return false;
+        }
+        LOG_INFO("UART initialized at %u baud (divisor %u)",
+                 static_cast<unsigned>(kActualBaudRate), static_cast<unsigned>(kDivisor));
+        return true;
+    }
+
+    int send(const uint8_t* data, size_t length) {
+        TRACE_BEGIN(start);
+        transmit(data, length);
+        TRACE_END(TRACE_UART_SEND, start, length);
+        return static_cast<int>(length);
+    }
+
+    int sendv(const IoVec* buffers, size_t count) {
+        TRACE_BEGIN(start);
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            transmit(buffers[i].data, buffers[i].length);
+            total += buffers[i].length;
+        }
+        TRACE_END(TRACE_UART_SENDV, start, total);
+        return static_cast<int>(total);
+    }
+
+    int sendv(std::initializer_list<IoVec> buffers) {
+        return sendv(buffers.begin(), buffers.size());
+    }
+
+    int send_string(std::string_view str) {
+        return send(reinterpret_cast<const uint8_t*>(str.data()), str.length());
+    }
+
+    // Non-blocking: drains whatever the RX ring holds, up to max_length
+    int receive(uint8_t* buffer, size_t max_length) {
+        return static_cast<int>(rx_ring_.read(buffer, max_length));
+    }
+
+    size_t available() const {
+        return rx_ring_.size();
+    }
+
+    template <typename Consumer>
+    size_t drain(Consumer&& consumer) {
+        return rx_ring_.consume(std::forward<Consumer>(consumer));
+    }
+
+    // RX interrupt / DMA-complete entry point, as drivers::UART
+    size_t on_rx_interrupt(const uint8_t* data, size_t length) {
+        size_t queued = rx_ring_.write(data, length);
+        if (queued < length) {
+            rx_overruns_.fetch_add(length - queued, std::memory_order_relaxed);
+        }
+        return queued;
+    }
+
+    size_t rx_overruns() const {
+        return rx_overruns_.load(std::memory_order_relaxed);
+    }
+
+    // Push bytes into the transmit data register, untraced
+    void transmit(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            tx_data_ = data[i];
+        }
+    }
+
+private:
+    volatile uint8_t tx_data_ = 0;
+    RingBuffer<Policy::kRxBufferSize> rx_ring_;
+    std::atomic<size_t> rx_overruns_{0};
+};
+
+} // namespace fixed
+
+} // namespace drivers
+
+#endif // UART_FIXED_HPP
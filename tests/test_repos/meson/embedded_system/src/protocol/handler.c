@@ -1,59 +1,107 @@
 #include "handler.h"
-#include "protocol_generated.h"
-#include <stdio.h>
+#include "outbound.h"
+#include "core/log.h"
+#include "core/trace.h"
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
-static bool protocol_initialized = false;
+// Checked on every call; on its own cache line, away from the handler table
+static struct {
+    _Alignas(64) atomic_bool value;
+} protocol_initialized = {false};
+
+static bool protocol_ready(void) {
+    return atomic_load_explicit(&protocol_initialized.value, memory_order_acquire);
+}
+
+#ifdef ENABLE_DEBUG
+// Latency histogram each message type is recorded under
+static trace_point_t trace_point_for(size_t type) {
+    switch (type) {
+    case MSG_TYPE_REQUEST:
+        return TRACE_PROTOCOL_REQUEST;
+    case MSG_TYPE_RESPONSE:
+        return TRACE_PROTOCOL_RESPONSE;
+    case MSG_TYPE_EVENT:
+        return TRACE_PROTOCOL_EVENT;
+    default:
+        return TRACE_PROTOCOL_OTHER;
+    }
+}
+#endif
+
+// Live dispatch table: seeded from the generated defaults, overridable at runtime
+static _Atomic(protocol_handler_fn) handlers[PROTOCOL_MESSAGE_TYPE_COUNT];
 
 int protocol_init(void) {
-    printf("Protocol handler initializing...\n");
+    LOG_INFO("Protocol handler initializing...");
 
     // Initialize generated protocol handlers
     protocol_generated_init();
 
-    protocol_initialized = true;
+    for (size_t i = 0; i < PROTOCOL_MESSAGE_TYPE_COUNT; i++) {
+        atomic_store_explicit(&handlers[i], protocol_generated_handlers[i], memory_order_relaxed);
+    }
+
+    // Release: the seeded handler table is visible before the flag
+    atomic_store_explicit(&protocol_initialized.value, true, memory_order_release);
     return 0;
 }
 
 int protocol_handle_message(const protocol_message_t* msg) {
-    if (!protocol_initialized || msg == NULL) {
+    if (!protocol_ready() || msg == NULL) {
         return -1;
     }
 
-    printf("Handling message: type=%d, id=%u, size=%zu\n",
-           msg->type, msg->id, msg->payload_size);
+    LOG_DEBUG("Handling message: type=%d, id=%u, size=%zu",
+              msg->type, msg->id, msg->payload_size);
 
-    // Dispatch to generated handlers based on message type
-    switch (msg->type) {
-        case MSG_TYPE_REQUEST:
-            return protocol_generated_handle_request(msg->id, msg->payload, msg->payload_size);
+    // One bounds check and one indexed call, however many types there are
+    size_t type = (size_t)msg->type;
+    protocol_handler_fn fn = type < PROTOCOL_MESSAGE_TYPE_COUNT
+        ? atomic_load_explicit(&handlers[type], memory_order_acquire)
+        : NULL;
+    if (fn == NULL) {
+        LOG_WARN("Unknown message type: %d", msg->type);
+        return -1;
+    }
 
-        case MSG_TYPE_RESPONSE:
-            return protocol_generated_handle_response(msg->id, msg->payload, msg->payload_size);
+    TRACE_BEGIN(start);
+    int result = fn(msg->id, msg->payload, msg->payload_size);
+    TRACE_END(trace_point_for(type), start, msg->id);
+    return result;
+}
 
-        case MSG_TYPE_EVENT:
-            return protocol_generated_handle_event(msg->id, msg->payload, msg->payload_size);
+int protocol_register_handler(message_type_t type, protocol_handler_fn fn) {
+    size_t index = (size_t)type;
+    if (!protocol_ready() || index >= PROTOCOL_MESSAGE_TYPE_COUNT) {
+        return -1;
+    }
 
-        default:
-            printf("Unknown message type: %d\n", msg->type);
-            return -1;
+    if (fn == NULL) {
+        fn = protocol_generated_handlers[index];
     }
+    atomic_store_explicit(&handlers[index], fn, memory_order_release);
+    return 0;
 }
 
 int protocol_send_message(const protocol_message_t* msg) {
-    if (!protocol_initialized || msg == NULL) {
+    if (!protocol_ready() || msg == NULL) {
         return -1;
     }
 
-    printf("Sending message: type=%d, id=%u, size=%zu\n",
-           msg->type, msg->id, msg->payload_size);
+    LOG_DEBUG("Sending message: type=%d, id=%u, size=%zu",
+              msg->type, msg->id, msg->payload_size);
 
-    // Simulate sending
-    return 0;
+    TRACE_BEGIN(start);
+    int result = outbound_send(msg);
+    TRACE_END(TRACE_PROTOCOL_SEND, start, msg->id);
+    return result;
 }
 
 void protocol_cleanup(void) {
+    protocol_queue_stop();
     protocol_generated_cleanup();
-    protocol_initialized = false;
+    atomic_store_explicit(&protocol_initialized.value, false, memory_order_release);
 }
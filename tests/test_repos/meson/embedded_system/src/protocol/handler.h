@@ -2,15 +2,13 @@
 #define HANDLER_H
 
 #include "core/system.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-// Protocol message types (will be extended by generated code)
-typedef enum {
-    MSG_TYPE_UNKNOWN = 0,
-    MSG_TYPE_REQUEST = 1,
-    MSG_TYPE_RESPONSE = 2,
-    MSG_TYPE_EVENT = 3
-} message_type_t;
+// Protocol message types (message_type_t) and the default handler table
+// are generated from protocol.proto
+#include "protocol_generated.h"
 
 // Protocol message structure
 typedef struct {
@@ -26,9 +24,45 @@ int protocol_init(void);
 // Handle incoming message
 int protocol_handle_message(const protocol_message_t* msg);
 
-// Send message
+// Replace the handler for a message type after protocol_init(); NULL
+// restores the generated one. Safe while other threads are dispatching.
+int protocol_register_handler(message_type_t type, protocol_handler_fn fn);
+
+// Send message. Framed as sync, type, length (LE16), id (LE32), payload;
+// queued for the sender thread while the outbound queue is running,
+// written synchronously otherwise.
 int protocol_send_message(const protocol_message_t* msg);
 
+// Byte sink for framed messages (the UART in firmware). Set it before
+// sending; without one, sending is simulated.
+typedef int (*protocol_transport_fn)(const uint8_t* data, size_t length, void* ctx);
+void protocol_set_transport(protocol_transport_fn fn, void* ctx);
+
+// Outbound queue: producers enqueue lock-free, one sender thread coalesces
+// frames into large transport writes. Zero fields take the defaults.
+typedef struct {
+    size_t capacity;             // Queued messages, power of two (256)
+    size_t batch_size;           // Most frames per coalesced batch (32)
+    size_t batch_bytes;          // Most bytes per transport write (4096)
+    uint32_t flush_interval_ms;  // Longest a partial batch waits (2 ms)
+    bool block_when_full;        // Backpressure: wait for room instead of failing
+    size_t buffer_bytes;         // Frame storage, power of two (65536); frames
+                                 // over half of it are refused while queued
+} protocol_queue_config_t;
+
+typedef struct {
+    uint64_t frames;    // Frames sent through the queue
+    uint64_t writes;    // Transport writes, queued or synchronous
+    uint64_t bytes;     // Bytes handed to the transport
+    uint64_t rejected;  // Sends refused because the queue was full
+    uint64_t failed;    // Frames lost to transport writes that returned an error
+} protocol_queue_stats_t;
+
+int protocol_queue_start(const protocol_queue_config_t* config);
+// Flushes everything queued, then joins the sender thread
+void protocol_queue_stop(void);
+void protocol_queue_get_stats(protocol_queue_stats_t* stats);
+
 // Cleanup
 void protocol_cleanup(void);
 
@@ -0,0 +1,395 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime, pthread_condattr_setclock
+
+#include "outbound.h"
+#include "core/log.h"
+#include "core/memory.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#define DEFAULT_CAPACITY 256
+#define DEFAULT_BATCH_SIZE 32
+#define DEFAULT_BATCH_BYTES 4096
+#define DEFAULT_FLUSH_INTERVAL_MS 2
+#define DEFAULT_BUFFER_BYTES 65536
+
+// Bounded MPSC ring of messages, one sequence number per slot. Frames are
+// built in place in a byte ring; a slot records where its frame lives.
+// Producers claim a slot and its bytes with one CAS on a packed head
+// (slot position high, byte position low, both mod 2^32), so frames sit in
+// the byte ring in slot order and the sender can hand contiguous runs of
+// them to the transport without copying.
+typedef struct {
+    _Atomic uint32_t seq;
+    uint32_t offset;  // byte position of the frame
+    uint32_t length;
+} outbound_slot_t;
+
+static struct {
+    outbound_slot_t* slots;
+    uint32_t mask;
+    uint8_t* buffer;
+    uint32_t buffer_mask;
+    protocol_queue_config_t config;
+
+    _Alignas(64) _Atomic uint64_t head;        // slot position << 32 | byte position
+    _Alignas(64) uint32_t dequeue_pos;
+    _Atomic uint32_t buffer_tail;              // bytes before it are free again
+    _Alignas(64) atomic_size_t pending;
+    atomic_size_t producers;
+    atomic_size_t waiters;
+    atomic_bool running;
+
+    atomic_uint_fast64_t frames;
+    atomic_uint_fast64_t writes;
+    atomic_uint_fast64_t bytes;
+    atomic_uint_fast64_t rejected;
+    atomic_uint_fast64_t failed;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    pthread_cond_t space;
+} queue = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static protocol_transport_fn transport = NULL;
+static void* transport_ctx = NULL;
+
+void protocol_set_transport(protocol_transport_fn fn, void* ctx) {
+    transport = fn;
+    transport_ctx = ctx;
+}
+
+// frames: how many frames `data` holds; all of them count as failed when
+// the transport reports an error
+static int transport_write(const uint8_t* data, size_t length, size_t frames) {
+    atomic_fetch_add_explicit(&queue.writes, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&queue.bytes, length, memory_order_relaxed);
+    // Without a transport, sending is simulated
+    int result = transport ? transport(data, length, transport_ctx) : 0;
+    if (result < 0) {
+        atomic_fetch_add_explicit(&queue.failed, frames, memory_order_relaxed);
+    }
+    return result;
+}
+
+// Frame header: sync, type, payload length (LE16), id (LE32)
+void outbound_write_header(uint8_t* out, const protocol_message_t* msg) {
+    out[0] = FRAME_SYNC;
+    out[1] = (uint8_t)msg->type;
+    out[2] = (uint8_t)msg->payload_size;
+    out[3] = (uint8_t)(msg->payload_size >> 8);
+    for (int i = 0; i < 4; i++) {
+        out[4 + i] = (uint8_t)(msg->id >> (8 * i));
+    }
+}
+
+static void deadline_after_ms(struct timespec* ts, uint32_t ms) {
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void wait_for_space(void) {
+    struct timespec deadline;
+    atomic_fetch_add_explicit(&queue.waiters, 1, memory_order_seq_cst);
+    pthread_mutex_lock(&queue.lock);
+    // Timed, so a wakeup that races the waiter count costs at most 1 ms
+    deadline_after_ms(&deadline, 1);
+    pthread_cond_timedwait(&queue.space, &queue.lock, &deadline);
+    pthread_mutex_unlock(&queue.lock);
+    atomic_fetch_sub_explicit(&queue.waiters, 1, memory_order_relaxed);
+}
+
+static inline uint64_t pack_head(uint32_t slot_pos, uint32_t byte_pos) {
+    return ((uint64_t)slot_pos << 32) | byte_pos;
+}
+
+// Claim the next slot and `length` contiguous bytes for its frame, padding
+// past the end of the byte ring rather than wrapping a frame. Returns the
+// slot, or NULL when the queue is full and the caller should not wait.
+static outbound_slot_t* reserve(size_t length, uint32_t* slot_pos) {
+    uint32_t capacity = queue.buffer_mask + 1;
+    uint64_t head = atomic_load_explicit(&queue.head, memory_order_relaxed);
+    for (;;) {
+        uint32_t pos = (uint32_t)(head >> 32);
+        uint32_t byte_pos = (uint32_t)head;
+        outbound_slot_t* slot = &queue.slots[pos & queue.mask];
+        int32_t diff = (int32_t)(atomic_load_explicit(&slot->seq, memory_order_acquire) - pos);
+
+        if (diff == 0) {
+            uint32_t contiguous = capacity - (byte_pos & queue.buffer_mask);
+            uint32_t start = length <= contiguous ? byte_pos : byte_pos + contiguous;
+            uint32_t used = byte_pos - atomic_load_explicit(&queue.buffer_tail, memory_order_acquire);
+            if (used + (start - byte_pos) + length <= capacity) {
+                uint64_t next = pack_head(pos + 1, start + (uint32_t)length);
+                if (atomic_compare_exchange_weak_explicit(&queue.head, &head, next,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                    slot->offset = start;
+                    slot->length = (uint32_t)length;
+                    *slot_pos = pos;
+                    return slot;
+                }
+                continue;
+            }
+        } else if (diff > 0) {
+            // Another producer claimed this slot first
+            head = atomic_load_explicit(&queue.head, memory_order_relaxed);
+            continue;
+        }
+
+        // Out of slots or bytes: fail fast, or wait for the sender to make room
+        if (!queue.config.block_when_full ||
+            !atomic_load_explicit(&queue.running, memory_order_acquire)) {
+            return NULL;
+        }
+        wait_for_space();
+        head = atomic_load_explicit(&queue.head, memory_order_relaxed);
+    }
+}
+
+static void commit(outbound_slot_t* slot, uint32_t pos) {
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+
+    // Wake the sender early once a full batch is waiting
+    size_t pending = atomic_fetch_add_explicit(&queue.pending, 1, memory_order_release) + 1;
+    if (pending == queue.config.batch_size) {
+        pthread_mutex_lock(&queue.lock);
+        pthread_cond_signal(&queue.ready);
+        pthread_mutex_unlock(&queue.lock);
+    }
+}
+
+// Hand [start, start + length) of the byte ring to the transport, then free it
+static void flush_span(uint32_t start, uint32_t length, size_t frames) {
+    transport_write(queue.buffer + (start & queue.buffer_mask), length, frames);
+    atomic_store_explicit(&queue.buffer_tail, start + length, memory_order_release);
+}
+
+// Send up to batch_size queued frames as as few transport writes as
+// batch_bytes and the wrap of the byte ring allow; returns frames sent
+static size_t drain_batch(void) {
+    uint32_t capacity = queue.buffer_mask + 1;
+    uint32_t span_start = 0;
+    uint32_t span_length = 0;
+    size_t span_frames = 0;
+    size_t sent = 0;
+
+    while (sent < queue.config.batch_size) {
+        outbound_slot_t* slot = &queue.slots[queue.dequeue_pos & queue.mask];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != queue.dequeue_pos + 1) {
+            break;
+        }
+        uint32_t offset = slot->offset;
+        uint32_t length = slot->length;
+
+        // Frames are contiguous in slot order apart from the ring wrap
+        bool joins = offset == span_start + span_length &&
+                     (span_start & queue.buffer_mask) + span_length + length <= capacity &&
+                     span_length + length <= queue.config.batch_bytes;
+        if (span_frames > 0 && !joins) {
+            flush_span(span_start, span_length, span_frames);
+            span_frames = 0;
+        }
+        if (span_frames == 0) {
+            span_start = offset;
+            span_length = 0;
+        }
+        span_length += length;
+        span_frames++;
+
+        atomic_store_explicit(&slot->seq, queue.dequeue_pos + queue.mask + 1, memory_order_release);
+        queue.dequeue_pos++;
+        sent++;
+    }
+    if (span_frames > 0) {
+        flush_span(span_start, span_length, span_frames);
+    }
+
+    if (sent > 0) {
+        atomic_fetch_sub_explicit(&queue.pending, sent, memory_order_relaxed);
+        atomic_fetch_add_explicit(&queue.frames, sent, memory_order_relaxed);
+        if (atomic_load_explicit(&queue.waiters, memory_order_seq_cst) > 0) {
+            pthread_mutex_lock(&queue.lock);
+            pthread_cond_broadcast(&queue.space);
+            pthread_mutex_unlock(&queue.lock);
+        }
+    }
+    return sent;
+}
+
+static void* sender_main(void* arg) {
+    (void)arg;
+    for (;;) {
+        size_t sent = drain_batch();
+        bool running = atomic_load_explicit(&queue.running, memory_order_acquire);
+        if (!running && atomic_load_explicit(&queue.pending, memory_order_acquire) == 0) {
+            break;
+        }
+
+        // A partial batch means the queue ran dry: give it up to one flush
+        // interval to fill before sending what has arrived
+        if (sent < queue.config.batch_size && running) {
+            struct timespec deadline;
+            deadline_after_ms(&deadline, queue.config.flush_interval_ms);
+            pthread_mutex_lock(&queue.lock);
+            if (atomic_load_explicit(&queue.pending, memory_order_acquire) < queue.config.batch_size &&
+                atomic_load_explicit(&queue.running, memory_order_acquire)) {
+                pthread_cond_timedwait(&queue.ready, &queue.lock, &deadline);
+            }
+            pthread_mutex_unlock(&queue.lock);
+        }
+    }
+    return NULL;
+}
+
+int protocol_queue_start(const protocol_queue_config_t* config) {
+    if (atomic_load_explicit(&queue.running, memory_order_acquire)) {
+        return -1;
+    }
+
+    protocol_queue_config_t cfg = {0};
+    if (config != NULL) {
+        cfg = *config;
+    }
+    if (cfg.capacity == 0) {
+        cfg.capacity = DEFAULT_CAPACITY;
+    }
+    if (cfg.batch_size == 0) {
+        cfg.batch_size = DEFAULT_BATCH_SIZE;
+    }
+    if (cfg.batch_bytes == 0) {
+        cfg.batch_bytes = DEFAULT_BATCH_BYTES;
+    }
+    if (cfg.flush_interval_ms == 0) {
+        cfg.flush_interval_ms = DEFAULT_FLUSH_INTERVAL_MS;
+    }
+    if (cfg.buffer_bytes == 0) {
+        cfg.buffer_bytes = DEFAULT_BUFFER_BYTES;
+    }
+    if ((cfg.capacity & (cfg.capacity - 1)) != 0 || cfg.capacity > UINT32_MAX / 2 ||
+        (cfg.buffer_bytes & (cfg.buffer_bytes - 1)) != 0 || cfg.buffer_bytes > UINT32_MAX / 2) {
+        return -1;
+    }
+
+    queue.slots = memory_alloc(cfg.capacity * sizeof(outbound_slot_t));
+    queue.buffer = memory_alloc(cfg.buffer_bytes);
+    if (queue.slots == NULL || queue.buffer == NULL) {
+        memory_free(queue.slots);
+        memory_free(queue.buffer);
+        return -1;
+    }
+    for (size_t i = 0; i < cfg.capacity; i++) {
+        atomic_init(&queue.slots[i].seq, (uint32_t)i);
+    }
+
+    queue.config = cfg;
+    queue.mask = (uint32_t)cfg.capacity - 1;
+    queue.buffer_mask = (uint32_t)cfg.buffer_bytes - 1;
+    queue.dequeue_pos = 0;
+    atomic_store_explicit(&queue.head, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue.buffer_tail, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue.pending, 0, memory_order_relaxed);
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queue.ready, &attr);
+    pthread_cond_init(&queue.space, &attr);
+    pthread_condattr_destroy(&attr);
+
+    atomic_store_explicit(&queue.running, true, memory_order_seq_cst);
+    if (pthread_create(&queue.thread, NULL, sender_main, NULL) != 0) {
+        atomic_store_explicit(&queue.running, false, memory_order_seq_cst);
+        memory_free(queue.slots);
+        memory_free(queue.buffer);
+        return -1;
+    }
+
+    LOG_INFO("Outbound queue started (capacity %zu, batch %zu, flush %u ms)",
+             cfg.capacity, cfg.batch_size, (unsigned)cfg.flush_interval_ms);
+    return 0;
+}
+
+void protocol_queue_stop(void) {
+    if (!atomic_exchange_explicit(&queue.running, false, memory_order_seq_cst)) {
+        return;
+    }
+
+    // Producers that already saw the queue running finish enqueueing first
+    const struct timespec pause = {0, 100000};
+    while (atomic_load_explicit(&queue.producers, memory_order_seq_cst) > 0) {
+        nanosleep(&pause, NULL);
+    }
+
+    pthread_mutex_lock(&queue.lock);
+    pthread_cond_signal(&queue.ready);
+    pthread_mutex_unlock(&queue.lock);
+    pthread_join(queue.thread, NULL);
+
+    pthread_cond_destroy(&queue.ready);
+    pthread_cond_destroy(&queue.space);
+    memory_free(queue.slots);
+    memory_free(queue.buffer);
+    queue.slots = NULL;
+    queue.buffer = NULL;
+}
+
+void protocol_queue_get_stats(protocol_queue_stats_t* stats) {
+    if (stats == NULL) {
+        return;
+    }
+    stats->frames = atomic_load_explicit(&queue.frames, memory_order_relaxed);
+    stats->writes = atomic_load_explicit(&queue.writes, memory_order_relaxed);
+    stats->bytes = atomic_load_explicit(&queue.bytes, memory_order_relaxed);
+    stats->rejected = atomic_load_explicit(&queue.rejected, memory_order_relaxed);
+    stats->failed = atomic_load_explicit(&queue.failed, memory_order_relaxed);
+}
+
+static void write_frame(uint8_t* out, const protocol_message_t* msg) {
+    outbound_write_header(out, msg);
+    if (msg->payload_size > 0) {
+        memcpy(out + FRAME_HEADER_SIZE, msg->payload, msg->payload_size);
+    }
+}
+
+int outbound_send(const protocol_message_t* msg) {
+    if (msg->payload_size > FRAME_MAX_PAYLOAD || (msg->payload_size > 0 && msg->payload == NULL)) {
+        return -1;
+    }
+
+    size_t length = FRAME_HEADER_SIZE + msg->payload_size;
+    atomic_fetch_add_explicit(&queue.producers, 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&queue.running, memory_order_seq_cst)) {
+        // The caller keeps its payload: it is copied once, into the byte ring
+        uint32_t pos;
+        outbound_slot_t* slot = length <= queue.config.buffer_bytes / 2 ? reserve(length, &pos) : NULL;
+        if (slot != NULL) {
+            write_frame(queue.buffer + (slot->offset & queue.buffer_mask), msg);
+            commit(slot, pos);
+        } else {
+            atomic_fetch_add_explicit(&queue.rejected, 1, memory_order_relaxed);
+        }
+        atomic_fetch_sub_explicit(&queue.producers, 1, memory_order_release);
+        return slot != NULL ? 0 : -1;
+    }
+    atomic_fetch_sub_explicit(&queue.producers, 1, memory_order_release);
+
+    // Queue not running: one synchronous write per message
+    uint8_t* frame = memory_alloc(length);
+    if (frame == NULL) {
+        return -1;
+    }
+    write_frame(frame, msg);
+    int result = transport_write(frame, length, 1);
+    memory_free(frame);
+    return result;
+}
@@ -0,0 +1,18 @@
+#ifndef OUTBOUND_H
+#define OUTBOUND_H
+
+#include "handler.h"
+
+// Wire frame: sync, type, payload length (LE16), id (LE32), payload
+#define FRAME_SYNC 0x7E
+#define FRAME_HEADER_SIZE 8
+#define FRAME_MAX_PAYLOAD UINT16_MAX
+
+// Write the frame header for msg into out[0..FRAME_HEADER_SIZE)
+void outbound_write_header(uint8_t* out, const protocol_message_t* msg);
+
+// Private to libprotocol: frame a message and hand it to the transport,
+// through the outbound queue when it is running
+int outbound_send(const protocol_message_t* msg);
+
+#endif // OUTBOUND_H
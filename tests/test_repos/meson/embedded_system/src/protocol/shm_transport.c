@@ -0,0 +1,464 @@
+#if defined(__linux__)
+#define _GNU_SOURCE  // syscall(SYS_futex)
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "shm_transport.h"
+#include "outbound.h"
+#include "core/log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define SHM_MAGIC 0x53484D52u  // "SHMR"
+#define SHM_VERSION 1u
+#define SHM_DEFAULT_CAPACITY (1u << 20)
+#define SHM_NAME_MAX 255
+#define SHM_TRANSPORT_TIMEOUT_MS 100
+
+// Record header: one 32-bit word, 0 until the writer commits the record
+#define RECORD_HEADER_SIZE 8
+#define RECORD_COMMITTED 0x80000000u
+#define RECORD_PADDING 0x40000000u
+#define RECORD_LENGTH_MASK 0x3FFFFFFFu
+
+// Counters and indices are shared with other processes through the
+// mapping, which works only if the atomics are address-free
+_Static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LONG_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+               "shared-memory ring needs lock-free atomics");
+
+// Layout at the start of the shared object; the data ring follows it
+typedef struct {
+    _Atomic uint32_t magic;  // Stored last by the creator
+    uint32_t version;
+    uint64_t capacity;
+
+    _Alignas(64) _Atomic uint64_t head;       // Writers reserve here
+    _Alignas(64) _Atomic uint64_t tail;       // Reader releases here
+    _Alignas(64) _Atomic uint32_t data_seq;   // Futex: bumped per commit
+    _Atomic uint32_t reader_waiting;
+    _Alignas(64) _Atomic uint32_t space_seq;  // Futex: bumped per release
+    _Atomic uint32_t writers_waiting;
+
+    _Alignas(64) _Atomic uint64_t records;
+    _Atomic uint64_t bytes;
+    _Atomic uint64_t full_waits;
+} shm_ring_t;
+
+struct shm_channel {
+    shm_ring_t* ring;
+    uint8_t* data;
+    uint64_t mask;
+    size_t map_size;
+    bool owner;
+    char name[SHM_NAME_MAX + 1];
+
+    // Reader cursor: private to the reading process
+    bool in_record;
+    uint64_t record_pos;
+    uint64_t record_end;
+    size_t offset;
+    size_t length;
+};
+
+static size_t record_size(size_t length) {
+    return RECORD_HEADER_SIZE + ((length + 7) & ~(size_t)7);
+}
+
+static _Atomic uint32_t* record_word(shm_channel_t* ch, uint64_t pos) {
+    return (_Atomic uint32_t*)(void*)(ch->data + (pos & ch->mask));
+}
+
+// Absolute CLOCK_MONOTONIC deadline; NULL for "wait forever"
+static const struct timespec* deadline_after(struct timespec* ts, int timeout_ms) {
+    if (timeout_ms < 0) {
+        return NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += timeout_ms / 1000;
+    ts->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+static bool deadline_passed(const struct timespec* deadline) {
+    if (deadline == NULL) {
+        return false;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec ||
+           (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+// Sleep while *word == seq. The mapping is shared between processes, so
+// these are the non-private futex ops. Elsewhere, poll at 50 us.
+static void futex_wait(_Atomic uint32_t* word, uint32_t seq, const struct timespec* deadline) {
+#if defined(__linux__)
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT_BITSET, seq, deadline, NULL, FUTEX_BITSET_MATCH_ANY);
+#else
+    (void)deadline;
+    const struct timespec pause = {0, 50000};
+    if (atomic_load_explicit(word, memory_order_acquire) == seq) {
+        nanosleep(&pause, NULL);
+    }
+#endif
+}
+
+static void futex_wake(_Atomic uint32_t* word, int count) {
+#if defined(__linux__)
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, count, NULL, NULL, 0);
+#else
+    (void)word;
+    (void)count;
+#endif
+}
+
+static shm_channel_t* channel_map(const char* name, int fd, size_t map_size, bool owner) {
+    void* base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+
+    shm_channel_t* ch = calloc(1, sizeof(*ch));
+    if (ch == NULL) {
+        munmap(base, map_size);
+        return NULL;
+    }
+    ch->ring = base;
+    ch->data = (uint8_t*)base + sizeof(shm_ring_t);
+    ch->map_size = map_size;
+    ch->owner = owner;
+    strcpy(ch->name, name);
+    return ch;
+}
+
+shm_channel_t* shm_channel_create(const char* name, size_t capacity) {
+    if (name == NULL || strlen(name) > SHM_NAME_MAX) {
+        return NULL;
+    }
+    if (capacity == 0) {
+        capacity = SHM_DEFAULT_CAPACITY;
+    }
+    if ((capacity & (capacity - 1)) != 0 || capacity < 64 || capacity > RECORD_LENGTH_MASK) {
+        return NULL;
+    }
+
+    // A ring left behind by a crashed run is replaced, never reused
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        LOG_ERROR("shm_open(%s) failed: %s", name, strerror(errno));
+        return NULL;
+    }
+
+    size_t map_size = sizeof(shm_ring_t) + capacity;
+    if (ftruncate(fd, (off_t)map_size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    // ftruncate zero-fills: every record word starts out uncommitted
+    shm_channel_t* ch = channel_map(name, fd, map_size, true);
+    if (ch == NULL) {
+        shm_unlink(name);
+        return NULL;
+    }
+    ch->mask = capacity - 1;
+    ch->ring->version = SHM_VERSION;
+    ch->ring->capacity = capacity;
+    atomic_store_explicit(&ch->ring->magic, SHM_MAGIC, memory_order_release);
+
+    LOG_INFO("Shared-memory channel %s created (%zu bytes)", name, capacity);
+    return ch;
+}
+
+shm_channel_t* shm_channel_open(const char* name) {
+    if (name == NULL || strlen(name) > SHM_NAME_MAX) {
+        return NULL;
+    }
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size <= sizeof(shm_ring_t)) {
+        close(fd);
+        return NULL;
+    }
+
+    shm_channel_t* ch = channel_map(name, fd, (size_t)st.st_size, false);
+    if (ch == NULL) {
+        return NULL;
+    }
+    shm_ring_t* ring = ch->ring;
+    if (atomic_load_explicit(&ring->magic, memory_order_acquire) != SHM_MAGIC ||
+        ring->version != SHM_VERSION || sizeof(shm_ring_t) + ring->capacity != ch->map_size) {
+        LOG_WARN("%s is not a shared-memory channel", name);
+        shm_channel_close(ch);
+        return NULL;
+    }
+    ch->mask = ring->capacity - 1;
+    return ch;
+}
+
+void shm_channel_close(shm_channel_t* channel) {
+    if (channel == NULL) {
+        return;
+    }
+    munmap(channel->ring, channel->map_size);
+    if (channel->owner) {
+        shm_unlink(channel->name);
+    }
+    free(channel);
+}
+
+// Claim record_size(length) contiguous bytes, padding to the end of the
+// ring when the record would wrap. Returns the record position, or
+// UINT64_MAX when no room turned up before the deadline.
+static uint64_t reserve(shm_channel_t* ch, size_t length, int timeout_ms) {
+    shm_ring_t* ring = ch->ring;
+    uint64_t capacity = ch->mask + 1;
+    uint64_t need = record_size(length);
+    struct timespec ts;
+    const struct timespec* deadline = NULL;
+    bool counted = false;
+
+    uint64_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    for (;;) {
+        uint64_t contiguous = capacity - (pos & ch->mask);
+        uint64_t total = need <= contiguous ? need : contiguous + need;
+
+        uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (total <= capacity - (pos - tail)) {
+            if (atomic_compare_exchange_weak_explicit(&ring->head, &pos, pos + total,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                if (total != need) {
+                    // The reader skips the padding on its own
+                    atomic_store_explicit(record_word(ch, pos), RECORD_COMMITTED | RECORD_PADDING |
+                                          (uint32_t)contiguous, memory_order_release);
+                    pos += contiguous;
+                }
+                return pos;
+            }
+            continue;
+        }
+
+        // Full: fail fast, or sleep until the reader releases something
+        if (timeout_ms == 0) {
+            return UINT64_MAX;
+        }
+        if (!counted) {
+            atomic_fetch_add_explicit(&ring->full_waits, 1, memory_order_relaxed);
+            deadline = deadline_after(&ts, timeout_ms);
+            counted = true;
+        }
+        if (deadline_passed(deadline)) {
+            return UINT64_MAX;
+        }
+
+        uint32_t seq = atomic_load_explicit(&ring->space_seq, memory_order_acquire);
+        atomic_fetch_add_explicit(&ring->writers_waiting, 1, memory_order_seq_cst);
+        if (atomic_load_explicit(&ring->tail, memory_order_seq_cst) == tail) {
+            futex_wait(&ring->space_seq, seq, deadline);
+        }
+        atomic_fetch_sub_explicit(&ring->writers_waiting, 1, memory_order_relaxed);
+        pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    }
+}
+
+static void commit(shm_channel_t* ch, uint64_t pos, size_t length) {
+    shm_ring_t* ring = ch->ring;
+    atomic_store_explicit(record_word(ch, pos), RECORD_COMMITTED | (uint32_t)length, memory_order_release);
+    atomic_fetch_add_explicit(&ring->records, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&ring->bytes, length, memory_order_relaxed);
+
+    // Only enter the kernel when the reader is (about to be) asleep
+    atomic_fetch_add_explicit(&ring->data_seq, 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&ring->reader_waiting, memory_order_seq_cst) > 0) {
+        futex_wake(&ring->data_seq, 1);
+    }
+}
+
+static bool record_fits(const shm_channel_t* ch, size_t length) {
+    return record_size(length) <= (ch->mask + 1) / 2;
+}
+
+int shm_channel_write(shm_channel_t* channel, const uint8_t* data, size_t length, int timeout_ms) {
+    if (channel == NULL || (length > 0 && data == NULL) || !record_fits(channel, length)) {
+        return -1;
+    }
+
+    uint64_t pos = reserve(channel, length, timeout_ms);
+    if (pos == UINT64_MAX) {
+        return -1;
+    }
+    memcpy(channel->data + (pos & channel->mask) + RECORD_HEADER_SIZE, data, length);
+    commit(channel, pos, length);
+    return 0;
+}
+
+int shm_transport_write(const uint8_t* data, size_t length, void* ctx) {
+    return shm_channel_write(ctx, data, length, SHM_TRANSPORT_TIMEOUT_MS);
+}
+
+int shm_channel_send(shm_channel_t* channel, const protocol_message_t* msg, int timeout_ms) {
+    if (channel == NULL || msg == NULL || msg->payload_size > FRAME_MAX_PAYLOAD ||
+        (msg->payload_size > 0 && msg->payload == NULL)) {
+        return -1;
+    }
+
+    size_t length = FRAME_HEADER_SIZE + msg->payload_size;
+    if (!record_fits(channel, length)) {
+        return -1;
+    }
+    uint64_t pos = reserve(channel, length, timeout_ms);
+    if (pos == UINT64_MAX) {
+        return -1;
+    }
+
+    uint8_t* frame = channel->data + (pos & channel->mask) + RECORD_HEADER_SIZE;
+    outbound_write_header(frame, msg);
+    if (msg->payload_size > 0) {
+        memcpy(frame + FRAME_HEADER_SIZE, msg->payload, msg->payload_size);
+    }
+    commit(channel, pos, length);
+    return 0;
+}
+
+// Give [tail, end) back to the writers. Scrubbing it keeps stale bytes
+// from reading as a committed header once a writer takes the space again.
+static void advance_tail(shm_channel_t* ch, uint64_t tail, uint64_t end) {
+    shm_ring_t* ring = ch->ring;
+    memset(ch->data + (tail & ch->mask), 0, (size_t)(end - tail));
+    atomic_store_explicit(&ring->tail, end, memory_order_seq_cst);
+
+    atomic_fetch_add_explicit(&ring->space_seq, 1, memory_order_seq_cst);
+    if (atomic_load_explicit(&ring->writers_waiting, memory_order_seq_cst) > 0) {
+        futex_wake(&ring->space_seq, INT_MAX);
+    }
+}
+
+void shm_channel_release(shm_channel_t* channel) {
+    if (channel != NULL && channel->in_record) {
+        channel->in_record = false;
+        advance_tail(channel, channel->record_pos, channel->record_end);
+    }
+}
+
+// Wait for the record at the reader's tail to be committed
+static uint32_t next_record(shm_channel_t* ch, uint64_t tail, int timeout_ms) {
+    shm_ring_t* ring = ch->ring;
+    _Atomic uint32_t* word = record_word(ch, tail);
+    uint32_t header = atomic_load_explicit(word, memory_order_acquire);
+    if (header != 0 || timeout_ms == 0) {
+        return header;
+    }
+
+    struct timespec ts;
+    const struct timespec* deadline = deadline_after(&ts, timeout_ms);
+    while (header == 0 && !deadline_passed(deadline)) {
+        uint32_t seq = atomic_load_explicit(&ring->data_seq, memory_order_acquire);
+        atomic_fetch_add_explicit(&ring->reader_waiting, 1, memory_order_seq_cst);
+        header = atomic_load_explicit(word, memory_order_seq_cst);
+        if (header == 0) {
+            futex_wait(&ring->data_seq, seq, deadline);
+            header = atomic_load_explicit(word, memory_order_acquire);
+        }
+        atomic_fetch_sub_explicit(&ring->reader_waiting, 1, memory_order_relaxed);
+    }
+    return header;
+}
+
+int shm_channel_receive(shm_channel_t* channel, protocol_message_t* msg, int timeout_ms) {
+    if (channel == NULL || msg == NULL) {
+        return -1;
+    }
+
+    while (!channel->in_record || channel->offset >= channel->length) {
+        shm_channel_release(channel);
+
+        uint64_t tail = atomic_load_explicit(&channel->ring->tail, memory_order_relaxed);
+        uint32_t header = next_record(channel, tail, timeout_ms);
+        if (header == 0) {
+            return 1;
+        }
+
+        size_t length = header & RECORD_LENGTH_MASK;
+        if (header & RECORD_PADDING) {
+            advance_tail(channel, tail, tail + length);
+            continue;
+        }
+        channel->in_record = true;
+        channel->record_pos = tail;
+        channel->record_end = tail + record_size(length);
+        channel->offset = 0;
+        channel->length = length;
+    }
+
+    uint8_t* frame = channel->data + (channel->record_pos & channel->mask) + RECORD_HEADER_SIZE +
+                     channel->offset;
+    size_t left = channel->length - channel->offset;
+    size_t payload_size = left >= FRAME_HEADER_SIZE ? (size_t)frame[2] | ((size_t)frame[3] << 8) : 0;
+    if (left < FRAME_HEADER_SIZE || frame[0] != FRAME_SYNC || FRAME_HEADER_SIZE + payload_size > left) {
+        // Nothing after a bad frame can be trusted: drop the whole record
+        LOG_WARN("Malformed frame in shared-memory channel %s", channel->name);
+        shm_channel_release(channel);
+        return -1;
+    }
+
+    msg->type = (message_type_t)frame[1];
+    msg->id = (uint32_t)frame[4] | ((uint32_t)frame[5] << 8) | ((uint32_t)frame[6] << 16) |
+              ((uint32_t)frame[7] << 24);
+    msg->payload = frame + FRAME_HEADER_SIZE;
+    msg->payload_size = payload_size;
+    channel->offset += FRAME_HEADER_SIZE + payload_size;
+    return 0;
+}
+
+size_t shm_channel_pump(shm_channel_t* channel, size_t max_messages, int timeout_ms) {
+    size_t handled = 0;
+    for (size_t i = 0; i < max_messages; i++) {
+        protocol_message_t msg;
+        int result = shm_channel_receive(channel, &msg, i == 0 ? timeout_ms : 0);
+        if (result > 0) {
+            break;
+        }
+        if (result == 0) {
+            protocol_handle_message(&msg);
+            handled++;
+        }
+    }
+
+    // Hand a fully read record back now rather than on the next call
+    if (channel != NULL && channel->in_record && channel->offset >= channel->length) {
+        shm_channel_release(channel);
+    }
+    return handled;
+}
+
+void shm_channel_get_stats(const shm_channel_t* channel, shm_channel_stats_t* stats) {
+    shm_ring_t* ring = channel->ring;
+    stats->records = atomic_load_explicit(&ring->records, memory_order_relaxed);
+    stats->bytes = atomic_load_explicit(&ring->bytes, memory_order_relaxed);
+    stats->full_waits = atomic_load_explicit(&ring->full_waits, memory_order_relaxed);
+}
@@ -0,0 +1,64 @@
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include "handler.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Shared-memory transport for host simulation (Linux): a byte ring in a
+// POSIX shared memory object (shm_open + mmap) that the firmware and host
+// tools map into their own address spaces. Any number of processes or
+// threads may write, one reads; waits use futexes on words in the mapping,
+// so an idle reader costs nothing and a writer only enters the kernel when
+// the reader is asleep. On other platforms create/open fail.
+//
+// One channel carries one direction. Each write is one record holding one
+// or more protocol frames (a coalesced outbound batch is a single record);
+// the reader gets the frames back one at a time, in place.
+typedef struct shm_channel shm_channel_t;
+
+// Create (or replace) the named ring, e.g. "/firmware.tx". capacity is the
+// ring size in bytes, a power of two (0 takes 1 MiB). The creator unlinks
+// the name again on close.
+shm_channel_t* shm_channel_create(const char* name, size_t capacity);
+
+// Map a ring another process created
+shm_channel_t* shm_channel_open(const char* name);
+
+void shm_channel_close(shm_channel_t* channel);
+
+// Write one record. timeout_ms: 0 fails at once when the ring is full,
+// negative waits for room for as long as it takes. Returns 0, -1 on timeout
+// or when the record is larger than half the ring.
+int shm_channel_write(shm_channel_t* channel, const uint8_t* data, size_t length, int timeout_ms);
+
+// protocol_transport_fn over shm_channel_write, for protocol_set_transport()
+// with the channel as ctx. Waits up to 100 ms for room while the ring is
+// full, so a reader that went away cannot wedge the sender thread.
+int shm_transport_write(const uint8_t* data, size_t length, void* ctx);
+
+// Frame msg straight into the ring (header and payload, no staging copy)
+int shm_channel_send(shm_channel_t* channel, const protocol_message_t* msg, int timeout_ms);
+
+// Reader: next frame, waiting up to timeout_ms as above. msg->payload
+// points into the ring and stays valid until the next receive or release.
+// Returns 0 with a message, 1 on timeout, -1 on a malformed record.
+int shm_channel_receive(shm_channel_t* channel, protocol_message_t* msg, int timeout_ms);
+
+// Reader: hand the rest of the current record back to the writers
+void shm_channel_release(shm_channel_t* channel);
+
+// Reader: feed up to max_messages frames to protocol_handle_message(),
+// waiting up to timeout_ms for the first one only. Returns frames handled.
+size_t shm_channel_pump(shm_channel_t* channel, size_t max_messages, int timeout_ms);
+
+typedef struct {
+    uint64_t records;      // Records committed by all writers
+    uint64_t bytes;        // Payload bytes in those records
+    uint64_t full_waits;   // Times a writer had to wait for room
+} shm_channel_stats_t;
+
+void shm_channel_get_stats(const shm_channel_t* channel, shm_channel_stats_t* stats);
+
+#endif // SHM_TRANSPORT_H
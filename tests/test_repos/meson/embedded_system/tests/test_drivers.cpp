@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "drivers/uart.hpp"
 #include "drivers/spi.hpp"
+#include <thread>
 
 extern "C" {
     #include "core/system.h"
@@ -25,6 +26,26 @@ TEST_F(DriverTest, UARTInit) {
     EXPECT_TRUE(uart.init());
 }
 
+// Test drivers refuse to start while the system reports an error
+TEST_F(DriverTest, InitRespectsSystemStatus) {
+    system_set_status(SYSTEM_STATUS_ERROR);
+
+    drivers::UART uart(115200);
+    drivers::SPI spi(1000000, drivers::SPIMode::MODE_0);
+    std::thread other([&] {
+        EXPECT_FALSE(uart.init());
+        EXPECT_FALSE(spi.init());
+    });
+    other.join();
+
+    uint8_t byte = 0;
+    EXPECT_EQ(uart.send(&byte, 1), -1);
+
+    system_set_status(SYSTEM_STATUS_OK);
+    EXPECT_TRUE(uart.init());
+    EXPECT_TRUE(spi.init());
+}
+
 // Test UART send
 TEST_F(DriverTest, UARTSend) {
     drivers::UART uart(115200);
@@ -45,6 +66,88 @@ TEST_F(DriverTest, UARTSendString) {
     EXPECT_EQ(sent, msg.length());
 }
 
+// Test UART send string from a non-owning view
+TEST_F(DriverTest, UARTSendStringView) {
+    drivers::UART uart(115200);
+    uart.init();
+
+    std::string_view msg = "Hello, UART!";
+    EXPECT_EQ(uart.send_string(msg), static_cast<int>(msg.length()));
+    EXPECT_EQ(uart.send_string(msg.substr(0, 5)), 5);
+}
+
+// Test UART gathered send
+TEST_F(DriverTest, UARTSendv) {
+    drivers::UART uart(115200);
+
+    const uint8_t header[] = {0x7E, 0x01};
+    const uint8_t payload[] = {0x01, 0x02, 0x03, 0x04};
+    EXPECT_EQ(uart.sendv({{header, sizeof(header)}, {payload, sizeof(payload)}}), -1);
+
+    uart.init();
+    EXPECT_EQ(uart.sendv({{header, sizeof(header)}, {payload, sizeof(payload)}}),
+              static_cast<int>(sizeof(header) + sizeof(payload)));
+    EXPECT_EQ(uart.sendv(nullptr, 0), 0);
+}
+
+// Test UART bulk receive from the interrupt-fed ring
+TEST_F(DriverTest, UARTReceiveBuffered) {
+    drivers::UART uart(115200);
+    uart.init();
+
+    uint8_t buffer[16];
+    EXPECT_EQ(uart.available(), 0u);
+    EXPECT_EQ(uart.read_some(buffer, sizeof(buffer)), 0);
+
+    const uint8_t frame[] = {0x7E, 0x01, 0x02, 0x03, 0x04, 0x05};
+    EXPECT_EQ(uart.on_rx_interrupt(frame, sizeof(frame)), sizeof(frame));
+    EXPECT_EQ(uart.available(), sizeof(frame));
+
+    EXPECT_EQ(uart.read_some(buffer, 4), 4);
+    EXPECT_EQ(buffer[0], 0x7E);
+    EXPECT_EQ(uart.receive(buffer, sizeof(buffer)), 2);
+    EXPECT_EQ(buffer[1], 0x05);
+    EXPECT_EQ(uart.available(), 0u);
+}
+
+// Test UART in-place drain and overrun accounting
+TEST_F(DriverTest, UARTDrainAndOverrun) {
+    drivers::UART uart(115200);
+    uart.init();
+
+    std::vector<uint8_t> burst(1500, 0xAB);
+    size_t queued = uart.on_rx_interrupt(burst.data(), burst.size());
+    EXPECT_EQ(queued + uart.rx_overruns(), burst.size());
+
+    size_t seen = 0;
+    size_t drained = uart.drain([&](const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            EXPECT_EQ(data[i], 0xAB);
+        }
+        seen += length;
+    });
+    EXPECT_EQ(drained, queued);
+    EXPECT_EQ(seen, queued);
+}
+
+// Test UART read with timeout, both expiring and woken by the RX side
+TEST_F(DriverTest, UARTReadTimeout) {
+    drivers::UART uart(115200);
+    uart.init();
+
+    uint8_t buffer[8];
+    EXPECT_EQ(uart.read_some(buffer, sizeof(buffer), std::chrono::milliseconds(10)), 0);
+
+    std::thread isr([&uart] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        const uint8_t data[] = {0x42, 0x43};
+        uart.on_rx_interrupt(data, sizeof(data));
+    });
+    EXPECT_EQ(uart.read_some(buffer, sizeof(buffer), std::chrono::seconds(5)), 2);
+    EXPECT_EQ(buffer[0], 0x42);
+    isr.join();
+}
+
 // Test SPI initialization
 TEST_F(DriverTest, SPIInit) {
     drivers::SPI spi(1000000, drivers::SPIMode::MODE_0);
@@ -62,6 +165,25 @@ TEST_F(DriverTest, SPITransfer) {
     EXPECT_EQ(rx_data.size(), tx_data.size());
 }
 
+// Test SPI transfer into caller buffers
+TEST_F(DriverTest, SPITransferBuffers) {
+    drivers::SPI spi(1000000, drivers::SPIMode::MODE_0);
+
+    uint8_t tx[4] = {0x01, 0x02, 0x03, 0x04};
+    uint8_t rx[4] = {};
+    EXPECT_EQ(spi.transfer(tx, rx, sizeof(tx)), -1);
+
+    spi.init();
+    EXPECT_EQ(spi.transfer(tx, rx, sizeof(tx)), 4);
+    EXPECT_EQ(rx[3], 0xFF);
+    EXPECT_EQ(spi.transfer(nullptr, rx, sizeof(rx)), 4);
+    EXPECT_EQ(spi.transfer(tx, nullptr, sizeof(tx)), 4);
+
+    // In-place half-duplex: buffer is replaced by the received bytes
+    EXPECT_EQ(spi.transfer(tx, sizeof(tx)), 4);
+    EXPECT_EQ(tx[0], 0xFF);
+}
+
 // Test SPI chip select
 TEST_F(DriverTest, SPIChipSelect) {
     drivers::SPI spi(1000000, drivers::SPIMode::MODE_0);
@@ -72,6 +194,231 @@ TEST_F(DriverTest, SPIChipSelect) {
     spi.set_cs(false);
 }
 
+// Test SPI batched transactions
+TEST_F(DriverTest, SPITransactionQueue) {
+    drivers::SPI spi(1000000, drivers::SPIMode::MODE_0);
+    spi.init();
+
+    uint8_t cmd[2] = {0x9F, 0x00};
+    uint8_t id[3] = {};
+    uint8_t sample[2] = {};
+    int completions = 0;
+    auto done = [&](const drivers::SPI::Transaction& t, int result) {
+        EXPECT_EQ(result, static_cast<int>(t.length));
+        ++completions;
+    };
+
+    drivers::SPI::Transaction command;
+    command.tx = cmd;
+    command.length = sizeof(cmd);
+    command.keep_cs = true;
+    spi.queue(command);
+
+    drivers::SPI::Transaction response;
+    response.rx = id;
+    response.length = sizeof(id);
+    response.on_complete = done;
+    spi.queue(response);
+
+    drivers::SPI::Transaction sensor;
+    sensor.rx = sample;
+    sensor.length = sizeof(sample);
+    sensor.mode = drivers::SPIMode::MODE_3;
+    sensor.clock_speed = 8000000;
+    sensor.on_complete = done;
+    spi.queue(sensor);
+
+    EXPECT_EQ(spi.pending(), 3u);
+    EXPECT_EQ(spi.execute(), 3u);
+    EXPECT_EQ(spi.pending(), 0u);
+    EXPECT_EQ(completions, 2);
+    EXPECT_EQ(id[0], 0xFF);
+    EXPECT_EQ(spi.mode(), drivers::SPIMode::MODE_3);
+    EXPECT_EQ(spi.clock_speed(), 8000000u);
+    EXPECT_EQ(spi.execute(), 0u);
+}
+
+// Test that transactions without a mode or clock keep the bus settings
+TEST_F(DriverTest, SPITransactionKeepsMode) {
+    drivers::SPI spi(4000000, drivers::SPIMode::MODE_3);
+    spi.init();
+
+    uint8_t rx[2] = {};
+    drivers::SPI::Transaction plain;
+    plain.rx = rx;
+    plain.length = sizeof(rx);
+    spi.queue(plain);
+    EXPECT_EQ(spi.execute(), 1u);
+    EXPECT_EQ(spi.mode(), drivers::SPIMode::MODE_3);
+    EXPECT_EQ(spi.clock_speed(), 4000000u);
+
+    // The same on a wrapped fixed bus, which cannot be reconfigured
+    drivers::fixed::SPI<4000000, drivers::SPIMode::MODE_3> device;
+    drivers::SPI wrapped(device);
+    wrapped.init();
+    int result = 0;
+    plain.on_complete = [&](const drivers::SPI::Transaction&, int r) { result = r; };
+    wrapped.queue(plain);
+    EXPECT_EQ(wrapped.execute(), 1u);
+    EXPECT_EQ(result, 2);
+}
+
+// Test that a completion callback can queue a follow-up transaction
+TEST_F(DriverTest, SPIQueueFromCallback) {
+    drivers::SPI spi(1000000, drivers::SPIMode::MODE_0);
+    spi.init();
+
+    uint8_t rx[4] = {};
+    int follow_ups = 0;
+    drivers::SPI::Transaction poll;
+    poll.rx = rx;
+    poll.length = sizeof(rx);
+    poll.on_complete = [&](const drivers::SPI::Transaction& t, int) {
+        drivers::SPI::Transaction next = t;
+        next.on_complete = [&](const drivers::SPI::Transaction&, int) { ++follow_ups; };
+        for (int i = 0; i < 8; ++i) {
+            spi.queue(next);
+        }
+    };
+    spi.queue(poll);
+
+    EXPECT_EQ(spi.execute(), 1u);
+    EXPECT_EQ(spi.pending(), 8u);
+    EXPECT_EQ(spi.execute(), 8u);
+    EXPECT_EQ(follow_ups, 8);
+    EXPECT_EQ(spi.pending(), 0u);
+}
+
+// Test compile-time UART configuration and the fixed-port I/O path
+TEST_F(DriverTest, FixedUART) {
+    using Console = drivers::fixed::UART<115200>;
+    static_assert(Console::kDivisor == 8, "14.7456 MHz / 16 / 115200");
+    static_assert(Console::kActualBaudRate == 115200, "exact divisor");
+    static_assert(Console::kByteTimeNs == 86805, "10 bit times at 115200");
+    static_assert(drivers::uart_divisor(14745600, 16, 0) == 0, "no divisor for 0 baud");
+
+    Console uart;
+    EXPECT_TRUE(uart.init());
+
+    const uint8_t data[] = {0x01, 0x02, 0x03};
+    EXPECT_EQ(uart.send(data, sizeof(data)), 3);
+    EXPECT_EQ(uart.sendv({{data, 1}, {data + 1, 2}}), 3);
+    EXPECT_EQ(uart.send_string("Hello"), 5);
+
+    uint8_t incoming[2048];
+    EXPECT_EQ(uart.on_rx_interrupt(incoming, sizeof(incoming)), 1024u);
+    EXPECT_EQ(uart.rx_overruns(), 1024u);
+    uint8_t buffer[16];
+    EXPECT_EQ(uart.receive(buffer, sizeof(buffer)), 16);
+    EXPECT_EQ(uart.available(), 1008u);
+
+    system_set_status(SYSTEM_STATUS_ERROR);
+    EXPECT_FALSE(uart.init());
+}
+
+// Test the runtime UART wrapping a fixed port
+TEST_F(DriverTest, UARTWrapsFixedPort) {
+    drivers::fixed::UART<921600> port;
+    drivers::UART uart(port);
+    EXPECT_EQ(uart.baud_rate(), 921600u);
+    EXPECT_EQ(uart.divisor(), 1u);
+
+    const uint8_t data[] = {0x01, 0x02, 0x03};
+    EXPECT_EQ(uart.send(data, sizeof(data)), -1);
+    EXPECT_TRUE(uart.init());
+    EXPECT_EQ(uart.send(data, sizeof(data)), 3);
+
+    uart.on_rx_interrupt(data, sizeof(data));
+    uint8_t buffer[8];
+    EXPECT_EQ(uart.read_some(buffer, sizeof(buffer), std::chrono::milliseconds(0)), 3);
+
+    // Rates the board clock cannot generate are refused at init
+    drivers::UART slow(10);
+    EXPECT_EQ(slow.divisor(), 0u);
+    EXPECT_FALSE(slow.init());
+}
+
+// Test compile-time SPI configuration and the runtime wrapper around it
+TEST_F(DriverTest, FixedSPI) {
+    using Flash = drivers::fixed::SPI<10000000, drivers::SPIMode::MODE_3>;
+    static_assert(Flash::kPrescaler == 8, "64 MHz / 8 is the fastest clock <= 10 MHz");
+    static_assert(Flash::kActualClockHz == 8000000, "64 MHz / 8");
+    static_assert(Flash::kBitTimeNs == 125, "8 MHz bit time");
+    static_assert(Flash::kCPOL && Flash::kCPHA, "mode 3");
+    static_assert(drivers::spi_prescaler(64000000, 100000) == 0, "too slow for /256");
+
+    Flash flash;
+    EXPECT_TRUE(flash.init());
+    uint8_t tx[4] = {0x01, 0x02, 0x03, 0x04};
+    uint8_t rx[4] = {};
+    EXPECT_EQ(flash.transfer(tx, rx, sizeof(tx)), 4);
+    EXPECT_EQ(rx[3], 0xFF);
+    EXPECT_EQ(flash.transfer(tx, sizeof(tx)), 4);
+    EXPECT_EQ(tx[0], 0xFF);
+    flash.set_cs(true);
+    EXPECT_TRUE(flash.cs_active());
+
+    drivers::SPI spi(flash);
+    EXPECT_EQ(spi.clock_speed(), 10000000u);
+    EXPECT_EQ(spi.mode(), drivers::SPIMode::MODE_3);
+    spi.init();
+    EXPECT_EQ(spi.transfer(nullptr, rx, sizeof(rx)), 4);
+
+    int failed = 0;
+    drivers::SPI::Transaction same;
+    same.rx = rx;
+    same.length = sizeof(rx);
+    same.mode = drivers::SPIMode::MODE_3;
+    spi.queue(same);
+
+    // The fixed bus cannot switch modes, so this one fails
+    drivers::SPI::Transaction other = same;
+    other.mode = drivers::SPIMode::MODE_0;
+    other.on_complete = [&](const drivers::SPI::Transaction&, int result) {
+        EXPECT_EQ(result, -1);
+        ++failed;
+    };
+    spi.queue(other);
+
+    EXPECT_EQ(spi.execute(), 1u);
+    EXPECT_EQ(failed, 1);
+    EXPECT_EQ(spi.mode(), drivers::SPIMode::MODE_3);
+}
+
+// Test a rejected transaction ends a chip-select chain held by keep_cs
+TEST_F(DriverTest, FixedSPIRejectReleasesCS) {
+    drivers::fixed::SPI<10000000, drivers::SPIMode::MODE_3> flash;
+    drivers::SPI spi(flash);
+    spi.init();
+
+    uint8_t rx[2] = {};
+    std::vector<bool> cs_seen;
+    auto record = [&](const drivers::SPI::Transaction&, int) { cs_seen.push_back(spi.cs_active()); };
+
+    drivers::SPI::Transaction held;
+    held.rx = rx;
+    held.length = sizeof(rx);
+    held.keep_cs = true;
+    held.on_complete = record;
+    spi.queue(held);
+
+    drivers::SPI::Transaction mismatched = held;
+    mismatched.keep_cs = false;
+    mismatched.mode = drivers::SPIMode::MODE_0;
+    spi.queue(mismatched);
+
+    drivers::SPI::Transaction normal = mismatched;
+    normal.mode.reset();
+    spi.queue(normal);
+
+    EXPECT_EQ(spi.execute(), 2u);
+    ASSERT_EQ(cs_seen.size(), 3u);
+    EXPECT_TRUE(cs_seen[0]);   // held after the keep_cs transaction
+    EXPECT_FALSE(cs_seen[1]);  // released by the rejection
+    EXPECT_FALSE(cs_seen[2]);
+    EXPECT_FALSE(spi.cs_active());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -4,6 +4,16 @@
 #include <cmocka.h>
 #include "core/system.h"
 #include "core/memory.h"
+#include "core/log.h"
+#include "core/scheduler.h"
+#include "core/trace.h"
+#include "protocol/handler.h"
+#include "protocol/shm_transport.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 // Test system initialization
 static void test_system_init(void **state) {
@@ -16,6 +26,30 @@ static void test_system_init(void **state) {
     system_shutdown();
 }
 
+// Test boot config comes from the linked-in snapshot and is validated
+static void test_config_snapshot(void **state) {
+    (void) state; // unused
+
+    assert_int_equal(system_init(), 0);
+    const system_config_t* config = system_get_config();
+    assert_int_equal(config->magic, SYSTEM_CONFIG_MAGIC);
+    assert_int_equal(config->version, SYSTEM_CONFIG_VERSION);
+    assert_int_equal(config->checksum, system_config_snapshot.checksum);
+
+    // Any corruption is rejected and leaves the active config alone
+    system_config_t copy = system_config_snapshot;
+    copy.debug_mode ^= 1;
+    assert_int_equal(system_load_config_snapshot(&copy, sizeof(copy)), -1);
+    copy = system_config_snapshot;
+    copy.version++;
+    assert_int_equal(system_load_config_snapshot(&copy, sizeof(copy)), -1);
+    assert_int_equal(system_load_config_snapshot(&copy, 4), -1);
+    assert_int_equal(system_get_config()->debug_mode, system_config_snapshot.debug_mode);
+
+    assert_int_equal(system_load_config_snapshot(&system_config_snapshot, sizeof(system_config_t)), 0);
+    system_shutdown();
+}
+
 // Test memory allocation
 static void test_memory_alloc(void **state) {
     (void) state; // unused
@@ -42,11 +76,807 @@ static void test_memory_bounds(void **state) {
     memory_cleanup();
 }
 
+// Test that freed blocks are reused and accounted as live bytes
+static void test_memory_free_reuse(void **state) {
+    (void) state; // unused
+
+    memory_init();
+
+    void* first = memory_alloc(100);
+    assert_non_null(first);
+    assert_int_equal(memory_get_used(), 128);
+
+    memory_free(first);
+    assert_int_equal(memory_get_used(), 0);
+
+    // Same size class hands back the block that was just freed
+    void* second = memory_alloc(120);
+    assert_ptr_equal(first, second);
+
+    memory_free(second);
+    memory_cleanup();
+}
+
+// Test that freeing a small block twice is caught, in both modes
+static void test_memory_double_free(void **state) {
+    (void) state; // unused
+
+    memory_mode_t modes[] = {MEMORY_MODE_SHARED, MEMORY_MODE_THREAD_CACHE};
+    for (int m = 0; m < 2; m++) {
+        memory_set_mode(modes[m]);
+        memory_init();
+
+        void* block = memory_alloc(48);
+        assert_non_null(block);
+        memory_free(block);
+        memory_free(block);
+        assert_int_equal(memory_get_used(), 0);
+
+        // The block went onto its free list once, so two callers get two blocks
+        void* first = memory_alloc(48);
+        void* second = memory_alloc(48);
+        assert_ptr_equal(first, block);
+        assert_ptr_not_equal(first, second);
+
+        memory_free(first);
+        memory_free(second);
+        assert_int_equal(memory_get_used(), 0);
+        memory_cleanup();
+    }
+    memory_set_mode(MEMORY_MODE_SHARED);
+}
+
+// Test that the pool survives steady-state alloc/free traffic
+static void test_memory_steady_state(void **state) {
+    (void) state; // unused
+
+    memory_init();
+
+    size_t available = memory_get_available();
+    for (int i = 0; i < 100000; i++) {
+        void* ptr = memory_alloc(256);
+        assert_non_null(ptr);
+        memory_free(ptr);
+    }
+    assert_int_equal(memory_get_used(), 0);
+    assert_int_equal(memory_get_available(), available);
+
+    memory_cleanup();
+}
+
+// Test that freed large blocks coalesce back into one region
+static void test_memory_coalesce(void **state) {
+    (void) state; // unused
+
+    memory_init();
+
+    void* blocks[4];
+    for (int i = 0; i < 4; i++) {
+        blocks[i] = memory_alloc(200 * 1024);
+        assert_non_null(blocks[i]);
+    }
+    assert_null(memory_alloc(400 * 1024));
+
+    // Free out of order so both forward and backward merges happen
+    memory_free(blocks[1]);
+    memory_free(blocks[3]);
+    memory_free(blocks[2]);
+    memory_free(blocks[0]);
+
+    void* big = memory_alloc(900 * 1024);
+    assert_non_null(big);
+    memory_free(big);
+
+    memory_cleanup();
+}
+
+// Test allocation counters and the per-class size histogram
+static void test_memory_stats(void **state) {
+    (void) state; // unused
+
+    memory_init();
+
+    void* small = memory_alloc(100);
+    void* large = memory_alloc(5000);
+    assert_non_null(small);
+    assert_non_null(large);
+    assert_null(memory_alloc(2 * 1024 * 1024));
+    memory_free(small);
+
+    memory_stats_t stats;
+    memory_get_stats(&stats);
+    assert_int_equal(stats.allocs, 2);
+    assert_int_equal(stats.frees, 1);
+    assert_int_equal(stats.failures, 1);
+    assert_int_equal(stats.bytes_requested, 5100);
+    assert_int_equal(stats.classes[2].max_size, 128);
+    assert_int_equal(stats.classes[2].allocs, 1);
+    assert_int_equal(stats.classes[2].frees, 1);
+    assert_int_equal(stats.classes[MEMORY_STATS_CLASSES - 1].allocs, 1);
+    assert_int_equal(stats.classes[MEMORY_STATS_CLASSES - 1].failures, 1);
+    assert_int_equal(stats.used, memory_get_used());
+    assert_true(stats.peak_used > stats.used);
+
+    memory_free(large);
+    memory_cleanup();
+}
+
+// Test arena bump allocation, scoped rewind and reset
+static void test_memory_arena(void **state) {
+    (void) state; // unused
+
+    memory_init();
+
+    assert_null(memory_arena_create(SIZE_MAX));
+    assert_null(memory_arena_create(SIZE_MAX - 3));
+
+    memory_arena_t* arena = memory_arena_create(256);
+    assert_non_null(arena);
+    size_t used_with_arena = memory_get_used();
+
+    uint8_t* a = memory_arena_alloc(arena, 10);
+    uint8_t* b = memory_arena_alloc(arena, 100);
+    assert_non_null(a);
+    assert_non_null(b);
+    assert_int_equal(((uintptr_t)b) % 8, 0);
+    assert_int_equal(memory_arena_used(arena), 16 + 104);
+
+    size_t mark = memory_arena_mark(arena);
+    assert_non_null(memory_arena_alloc(arena, 100));
+    assert_null(memory_arena_alloc(arena, 100));
+    memory_arena_rewind(arena, mark);
+    assert_int_equal(memory_arena_used(arena), mark);
+
+    // Arena allocations never touch the pool counters
+    assert_int_equal(memory_get_used(), used_with_arena);
+
+    memory_arena_reset(arena);
+    assert_ptr_equal(memory_arena_alloc(arena, 8), a);
+
+    memory_arena_destroy(arena);
+    assert_int_equal(memory_get_used(), 0);
+
+    memory_cleanup();
+}
+
+static void* thread_cache_worker(void* arg) {
+    (void) arg; // unused
+
+    void* live[16] = {NULL};
+    for (int i = 0; i < 20000; i++) {
+        int slot = i % 16;
+        memory_free(live[slot]);
+        live[slot] = memory_alloc((size_t)(16 << (i % 5)));
+        if (live[slot] == NULL) {
+            return (void*)1;
+        }
+    }
+    for (int slot = 0; slot < 16; slot++) {
+        memory_free(live[slot]);
+    }
+    return NULL;
+}
+
+// Test concurrent allocation through per-thread caches
+static void test_memory_thread_cache(void **state) {
+    (void) state; // unused
+
+    memory_set_mode(MEMORY_MODE_THREAD_CACHE);
+    memory_init();
+    assert_int_equal(memory_get_mode(), MEMORY_MODE_THREAD_CACHE);
+
+    pthread_t threads[8];
+    for (int i = 0; i < 8; i++) {
+        assert_int_equal(pthread_create(&threads[i], NULL, thread_cache_worker, NULL), 0);
+    }
+    for (int i = 0; i < 8; i++) {
+        void* failed;
+        pthread_join(threads[i], &failed);
+        assert_null(failed);
+    }
+    assert_int_equal(memory_get_used(), 0);
+
+    memory_set_mode(MEMORY_MODE_SHARED);
+    memory_cleanup();
+}
+
+// Test log ring buffering and overflow accounting
+static void test_log_ring(void **state) {
+    (void) state; // unused
+
+    log_stop();
+    log_flush();
+
+    log_write(LOG_LEVEL_DEBUG, "log test %d", 1);
+    LOG_ERROR("log test %d", 2);
+    assert_int_equal(log_flush(), 2);
+    assert_int_equal(log_flush(), 0);
+
+    size_t dropped = log_dropped();
+    for (int i = 0; i < LOG_RING_SIZE + 8; i++) {
+        log_write(LOG_LEVEL_INFO, "log fill %d", i);
+    }
+    assert_int_equal(log_dropped() - dropped, 8);
+    assert_int_equal(log_flush(), LOG_RING_SIZE);
+
+    // The drain thread empties the ring on its own
+    assert_int_equal(log_start(), 0);
+    log_write(LOG_LEVEL_INFO, "log async");
+    log_stop();
+    assert_int_equal(log_flush(), 0);
+}
+
+static int test_handler_calls = 0;
+
+static int test_handler(uint32_t id, const uint8_t* payload, size_t size) {
+    (void) payload;
+    test_handler_calls++;
+    return (int)(id + size);
+}
+
+// Test table dispatch and runtime handler registration
+static void test_protocol_dispatch(void **state) {
+    (void) state; // unused
+
+    // Encoded Event {event_id: 1}
+    uint8_t payload[4] = {0x08, 0x01, 0x18, 0x02};
+    protocol_message_t msg = {MSG_TYPE_EVENT, 7, payload, sizeof(payload)};
+
+    assert_int_equal(protocol_register_handler(MSG_TYPE_EVENT, test_handler), -1);
+    assert_int_equal(protocol_init(), 0);
+    assert_int_equal(protocol_handle_message(&msg), 0);
+
+    assert_int_equal(protocol_register_handler(MSG_TYPE_EVENT, test_handler), 0);
+    assert_int_equal(protocol_handle_message(&msg), 11);
+    assert_int_equal(test_handler_calls, 1);
+
+    // NULL restores the generated handler
+    assert_int_equal(protocol_register_handler(MSG_TYPE_EVENT, NULL), 0);
+    assert_int_equal(protocol_handle_message(&msg), 0);
+    assert_int_equal(test_handler_calls, 1);
+
+    // The generated handler rejects a payload its codec cannot decode
+    payload[0] = 0x00;
+    assert_int_equal(protocol_handle_message(&msg), -1);
+
+    msg.type = MSG_TYPE_UNKNOWN;
+    assert_int_equal(protocol_handle_message(&msg), -1);
+    msg.type = (message_type_t)PROTOCOL_MESSAGE_TYPE_COUNT;
+    assert_int_equal(protocol_handle_message(&msg), -1);
+    assert_int_equal(protocol_register_handler(msg.type, test_handler), -1);
+
+    protocol_cleanup();
+}
+
+// Test generated codec round trip with zero-copy views
+static void test_protocol_codec(void **state) {
+    (void) state; // unused
+
+    memory_init();
+
+    const char command[] = "read_sensor";
+    uint8_t data[200];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+
+    proto_event_t event = {0};
+    event.event_id = 300;
+    event.event_type.data = (const uint8_t*)command;
+    event.event_type.size = sizeof(command) - 1;
+    event.timestamp = -5;
+    event.data.data = data;
+    event.data.size = sizeof(data);
+
+    size_t size = proto_event_encoded_size(&event);
+    uint8_t* wire = memory_alloc(size);
+    assert_non_null(wire);
+    assert_int_equal(proto_event_encode(&event, wire, size - 1), -1);
+    assert_int_equal(proto_event_encode(&event, wire, size), (int)size);
+
+    proto_event_t decoded;
+    assert_int_equal(proto_event_decode(&decoded, wire, size), 0);
+    assert_int_equal(decoded.event_id, 300);
+    assert_true(decoded.timestamp == -5);
+    assert_int_equal(decoded.event_type.size, sizeof(command) - 1);
+    assert_memory_equal(decoded.event_type.data, command, sizeof(command) - 1);
+    // Views alias the pool buffer rather than copies of it
+    assert_true(decoded.data.data > wire && decoded.data.data < wire + size);
+    assert_memory_equal(decoded.data.data, data, sizeof(data));
+
+    // Envelope with a oneof sub-message, decoded lazily from its view
+    proto_protocol_message_t envelope = {0};
+    envelope.type = MSG_TYPE_EVENT;
+    envelope.event.data = wire;
+    envelope.event.size = size;
+    envelope.payload_case = 4;
+
+    uint8_t frame[512];
+    int frame_size = proto_protocol_message_encode(&envelope, frame, sizeof(frame));
+    assert_true(frame_size > (int)size);
+
+    proto_protocol_message_t parsed;
+    assert_int_equal(proto_protocol_message_decode(&parsed, frame, (size_t)frame_size), 0);
+    assert_int_equal(parsed.type, MSG_TYPE_EVENT);
+    assert_int_equal(parsed.payload_case, 4);
+    assert_int_equal(proto_event_decode(&decoded, parsed.event.data, parsed.event.size), 0);
+    assert_int_equal(decoded.event_id, 300);
+
+    // Unknown fields are skipped, truncated input is rejected
+    uint8_t unknown[] = {0x08, 0x05, 0x7A, 0x02, 0xAA, 0xBB, 0x10, 0x03};
+    proto_response_t response;
+    assert_int_equal(proto_response_decode(&response, unknown, sizeof(unknown)), 0);
+    assert_int_equal(response.request_id, 5);
+    assert_int_equal(response.status_code, 3);
+    assert_int_equal(proto_event_decode(&decoded, wire, size - 1), -1);
+
+    memory_free(wire);
+    memory_cleanup();
+}
+
+typedef struct {
+    int writes;
+    size_t bytes;
+    int bad_frames;
+    bool fail;  // Report every write as failed
+} capture_transport_t;
+
+static int capture_write(const uint8_t* data, size_t length, void* ctx) {
+    capture_transport_t* capture = ctx;
+    capture->writes++;
+    capture->bytes += length;
+    // Every write holds whole frames
+    for (size_t offset = 0; offset < length; ) {
+        size_t payload_size = (size_t)data[offset + 2] | ((size_t)data[offset + 3] << 8);
+        if (data[offset] != 0x7E) {
+            capture->bad_frames++;
+            break;
+        }
+        offset += 8 + payload_size;
+    }
+    return capture->fail ? -1 : 0;
+}
+
+#define QUEUE_PRODUCERS 4
+#define QUEUE_MESSAGES 200
+
+static void* queue_producer(void* arg) {
+    uint8_t payload[24];
+    memset(payload, (int)(intptr_t)arg, sizeof(payload));
+    protocol_message_t msg = {MSG_TYPE_EVENT, 0, payload, sizeof(payload)};
+    for (uint32_t i = 0; i < QUEUE_MESSAGES; i++) {
+        msg.id = i;
+        if (protocol_send_message(&msg) != 0) {
+            return (void*)1;
+        }
+    }
+    return NULL;
+}
+
+// Test batched outbound queue with several producers and backpressure
+static void test_protocol_queue(void **state) {
+    (void) state; // unused
+
+    capture_transport_t capture = {0};
+    assert_int_equal(system_init(), 0);
+    assert_int_equal(protocol_init(), 0);
+    protocol_set_transport(capture_write, &capture);
+
+    protocol_queue_stats_t before, after;
+    protocol_queue_get_stats(&before);
+
+    protocol_queue_config_t config = {0};
+    config.capacity = 64;
+    config.block_when_full = true;
+    assert_int_equal(protocol_queue_start(&config), 0);
+
+    pthread_t producers[QUEUE_PRODUCERS];
+    for (intptr_t t = 0; t < QUEUE_PRODUCERS; t++) {
+        pthread_create(&producers[t], NULL, queue_producer, (void*)t);
+    }
+    for (int t = 0; t < QUEUE_PRODUCERS; t++) {
+        void* result;
+        pthread_join(producers[t], &result);
+        assert_null(result);
+    }
+    protocol_queue_stop();
+
+    protocol_queue_get_stats(&after);
+    assert_int_equal(after.frames - before.frames, QUEUE_PRODUCERS * QUEUE_MESSAGES);
+    assert_int_equal(capture.bytes, QUEUE_PRODUCERS * QUEUE_MESSAGES * (8 + 24));
+    assert_int_equal(capture.bad_frames, 0);
+    // Coalescing: far fewer writes than messages
+    assert_true(capture.writes < QUEUE_PRODUCERS * QUEUE_MESSAGES / 4);
+
+    // Without backpressure a full queue rejects; a slow flush keeps it full
+    config.capacity = 4;
+    config.batch_size = 64;
+    config.flush_interval_ms = 1000;
+    config.block_when_full = false;
+    assert_int_equal(protocol_queue_start(&config), 0);
+    uint8_t payload[8] = {0};
+    protocol_message_t msg = {MSG_TYPE_EVENT, 1, payload, sizeof(payload)};
+    for (int i = 0; i < 4; i++) {
+        assert_int_equal(protocol_send_message(&msg), 0);
+    }
+    assert_int_equal(protocol_send_message(&msg), -1);
+    protocol_queue_stop();
+    protocol_queue_get_stats(&after);
+    assert_int_equal(after.rejected - before.rejected, 1);
+
+    // Frame storage runs out before the slots do
+    config.capacity = 64;
+    config.buffer_bytes = 64;
+    assert_int_equal(protocol_queue_start(&config), 0);
+    for (int i = 0; i < 4; i++) {
+        assert_int_equal(protocol_send_message(&msg), 0);
+    }
+    assert_int_equal(protocol_send_message(&msg), -1);
+    protocol_queue_stop();
+    protocol_queue_get_stats(&after);
+    assert_int_equal(after.rejected - before.rejected, 2);
+    assert_int_equal(after.failed - before.failed, 0);
+
+    // Failed transport writes count every frame they carried
+    capture.fail = true;
+    config.buffer_bytes = 0;
+    assert_int_equal(protocol_queue_start(&config), 0);
+    for (int i = 0; i < 3; i++) {
+        assert_int_equal(protocol_send_message(&msg), 0);
+    }
+    protocol_queue_stop();
+    protocol_queue_get_stats(&after);
+    assert_int_equal(after.failed - before.failed, 3);
+    assert_int_equal(protocol_send_message(&msg), -1);
+    protocol_queue_get_stats(&after);
+    assert_int_equal(after.failed - before.failed, 4);
+    capture.fail = false;
+    protocol_queue_get_stats(NULL);
+
+    // Stopped: sends are synchronous, one write each
+    int writes = capture.writes;
+    assert_int_equal(protocol_send_message(&msg), 0);
+    assert_int_equal(capture.writes, writes + 1);
+
+    protocol_set_transport(NULL, NULL);
+    protocol_cleanup();
+    system_shutdown();
+}
+
+#define SHM_TEST_CHANNEL "/embedded_system_test_shm"
+#define SHM_WRITERS 2
+#define SHM_MESSAGES 100000
+
+// Test shared-memory frames in both directions and dispatch from the ring
+static void test_shm_transport(void **state) {
+    (void) state; // unused
+
+    assert_null(shm_channel_open(SHM_TEST_CHANNEL));
+    assert_null(shm_channel_create(SHM_TEST_CHANNEL, 1000));
+    shm_channel_t* ring = shm_channel_create(SHM_TEST_CHANNEL, 4096);
+    assert_non_null(ring);
+    // A second mapping of the same object, as a host tool would have
+    shm_channel_t* peer = shm_channel_open(SHM_TEST_CHANNEL);
+    assert_non_null(peer);
+
+    uint8_t payload[4] = {0x08, 0x01, 0x18, 0x02};
+    protocol_message_t msg = {MSG_TYPE_EVENT, 7, payload, sizeof(payload)};
+    assert_int_equal(shm_channel_send(peer, &msg, 0), 0);
+    msg.id = 8;
+    msg.payload_size = 0;
+    assert_int_equal(shm_channel_send(peer, &msg, 0), 0);
+
+    protocol_message_t received;
+    assert_int_equal(shm_channel_receive(ring, &received, 0), 0);
+    assert_int_equal(received.type, MSG_TYPE_EVENT);
+    assert_int_equal(received.id, 7);
+    assert_int_equal(received.payload_size, sizeof(payload));
+    assert_memory_equal(received.payload, payload, sizeof(payload));
+    assert_int_equal(shm_channel_receive(ring, &received, 0), 0);
+    assert_int_equal(received.id, 8);
+    assert_int_equal(received.payload_size, 0);
+    assert_int_equal(shm_channel_receive(ring, &received, 0), 1);
+    assert_int_equal(shm_channel_receive(ring, &received, 5), 1);
+
+    // As the protocol transport: one record per write, frames split again
+    assert_int_equal(protocol_init(), 0);
+    protocol_set_transport(shm_transport_write, peer);
+    msg.payload_size = sizeof(payload);
+    assert_int_equal(protocol_send_message(&msg), 0);
+    protocol_set_transport(NULL, NULL);
+    assert_int_equal(shm_channel_receive(ring, &received, 0), 0);
+    assert_int_equal(received.id, 8);
+    assert_memory_equal(received.payload, payload, sizeof(payload));
+
+    // Inbound frames go through the handler table
+    test_handler_calls = 0;
+    assert_int_equal(protocol_register_handler(MSG_TYPE_EVENT, test_handler), 0);
+    for (uint32_t id = 0; id < 3; id++) {
+        msg.id = id;
+        assert_int_equal(shm_channel_send(peer, &msg, 0), 0);
+    }
+    assert_int_equal(shm_channel_pump(ring, 16, 0), 3);
+    assert_int_equal(test_handler_calls, 3);
+    assert_int_equal(shm_channel_pump(ring, 16, 0), 0);
+    protocol_cleanup();
+
+    // Records over half the ring never fit; a full ring fails without a wait
+    uint8_t big[4096] = {0};
+    assert_int_equal(shm_channel_write(peer, big, 2048, 0), -1);
+    assert_int_equal(shm_channel_write(peer, big, 1500, 0), 0);
+    assert_int_equal(shm_channel_write(peer, big, 1500, 0), 0);
+    assert_int_equal(shm_channel_write(peer, big, 1500, 0), -1);
+    assert_int_equal(shm_channel_write(peer, big, 1500, 10), -1);
+
+    // Garbage is dropped a record at a time
+    assert_int_equal(shm_channel_receive(ring, &received, 0), -1);
+    assert_int_equal(shm_channel_receive(ring, &received, 0), -1);
+    assert_int_equal(shm_channel_receive(ring, &received, 0), 1);
+
+    shm_channel_stats_t stats;
+    shm_channel_get_stats(peer, &stats);
+    assert_int_equal(stats.records, 8);
+    assert_int_equal(stats.full_waits, 1);
+
+    shm_channel_close(peer);
+    shm_channel_close(ring);
+    assert_null(shm_channel_open(SHM_TEST_CHANNEL));
+}
+
+static void* shm_writer(void* arg) {
+    shm_channel_t* peer = shm_channel_open(SHM_TEST_CHANNEL);
+    if (peer == NULL) {
+        return (void*)1;
+    }
+
+    uint8_t writer = (uint8_t)(uintptr_t)arg;
+    protocol_message_t msg = {MSG_TYPE_EVENT, 0, &writer, 1};
+    for (uint32_t i = 0; i < SHM_MESSAGES; i++) {
+        msg.id = i;
+        if (shm_channel_send(peer, &msg, -1) != 0) {
+            break;
+        }
+    }
+    shm_channel_close(peer);
+    return NULL;
+}
+
+// Test several writers against one reader through a small, wrapping ring
+static void test_shm_transport_writers(void **state) {
+    (void) state; // unused
+
+    shm_channel_t* ring = shm_channel_create(SHM_TEST_CHANNEL, 1024);
+    assert_non_null(ring);
+
+    pthread_t writers[SHM_WRITERS];
+    for (uintptr_t t = 0; t < SHM_WRITERS; t++) {
+        pthread_create(&writers[t], NULL, shm_writer, (void*)t);
+    }
+
+    // Each writer's frames arrive in order, interleaved with the others'
+    uint32_t next[SHM_WRITERS] = {0};
+    int out_of_order = 0;
+    for (int i = 0; i < SHM_WRITERS * SHM_MESSAGES; i++) {
+        protocol_message_t msg;
+        assert_int_equal(shm_channel_receive(ring, &msg, 5000), 0);
+        assert_int_equal(msg.payload_size, 1);
+        uint8_t writer = msg.payload[0];
+        assert_true(writer < SHM_WRITERS);
+        if (msg.id != next[writer]++) {
+            out_of_order++;
+        }
+    }
+    assert_int_equal(out_of_order, 0);
+
+    for (int t = 0; t < SHM_WRITERS; t++) {
+        void* result;
+        pthread_join(writers[t], &result);
+        assert_null(result);
+    }
+
+    protocol_message_t msg;
+    assert_int_equal(shm_channel_receive(ring, &msg, 0), 1);
+    shm_channel_stats_t stats;
+    shm_channel_get_stats(ring, &stats);
+    assert_int_equal(stats.records, SHM_WRITERS * SHM_MESSAGES);
+    shm_channel_close(ring);
+}
+
+static atomic_int tasks_run;
+static atomic_int dirty_arenas;
+
+// Fans out into a binary tree of tasks, so most work is spawned on worker
+// deques and has to be stolen to spread across the pool
+static void tree_task(void* arg, memory_arena_t* arena) {
+    uintptr_t depth = (uintptr_t)arg;
+    if (arena == NULL || memory_arena_used(arena) != 0) {
+        atomic_fetch_add(&dirty_arenas, 1);
+    }
+    memory_arena_alloc(arena, 64);
+    atomic_fetch_add(&tasks_run, 1);
+
+    if (depth > 0) {
+        scheduler_submit(tree_task, (void*)(depth - 1));
+        scheduler_submit(tree_task, (void*)(depth - 1));
+    }
+}
+
+// Test work-stealing pool with nested submission and per-task arenas
+static void test_scheduler(void **state) {
+    (void) state; // unused
+
+    memory_init();
+    assert_int_equal(scheduler_submit(tree_task, NULL), -1);
+
+    scheduler_config_t config = {0};
+    config.threads = 4;
+    assert_int_equal(scheduler_start(&config), 0);
+    assert_int_equal(scheduler_thread_count(), 4);
+
+    atomic_store(&tasks_run, 0);
+    atomic_store(&dirty_arenas, 0);
+    for (int i = 0; i < 4; i++) {
+        assert_int_equal(scheduler_submit(tree_task, (void*)(uintptr_t)8), 0);
+    }
+    scheduler_wait();
+    assert_int_equal(atomic_load(&tasks_run), 4 * 511);
+    assert_int_equal(atomic_load(&dirty_arenas), 0);
+
+    // Default config sizes the pool to the core count
+    scheduler_stop();
+    assert_int_equal(scheduler_start(NULL), 0);
+    assert_true(scheduler_thread_count() >= 1);
+    assert_int_equal(scheduler_submit(tree_task, (void*)(uintptr_t)2), 0);
+    scheduler_stop();
+    assert_int_equal(atomic_load(&tasks_run), 4 * 511 + 7);
+    assert_int_equal(scheduler_submit(tree_task, NULL), -1);
+    memory_cleanup();
+
+    // A full-size pool fits next to the outbound queue with room to spare
+    assert_int_equal(system_init(), 0);
+    assert_int_equal(protocol_init(), 0);
+    assert_int_equal(protocol_queue_start(NULL), 0);
+    config.threads = 64;  // MAX_WORKERS
+    assert_int_equal(scheduler_start(&config), 0);
+    assert_int_equal(scheduler_thread_count(), 64);
+    assert_int_equal(scheduler_submit(tree_task, (void*)(uintptr_t)4), 0);
+    scheduler_wait();
+    uint8_t payload[512] = {0};
+    protocol_message_t msg = {MSG_TYPE_EVENT, 1, payload, sizeof(payload)};
+    for (int i = 0; i < 64; i++) {
+        assert_int_equal(protocol_send_message(&msg), 0);
+    }
+    scheduler_stop();
+    config.queue_capacity = 2048;
+    assert_int_equal(scheduler_start(&config), -1);
+    protocol_cleanup();
+    system_shutdown();
+}
+
+// Test latency histograms and the metrics snapshot built on them
+static void test_trace_latency(void **state) {
+    (void) state; // unused
+
+    trace_init();
+    trace_reset();
+
+    // 1us..1000us in 1us steps: p50 ~500us, p99 ~990us, within the 6% bucket error
+    for (uint64_t i = 1; i <= 1000; i++) {
+        trace_record_ns(TRACE_SPI_TRANSFER, i * 10000, i * 1000, (uint32_t)i);
+    }
+
+    trace_latency_t latency;
+    assert_int_equal(trace_get_latency(TRACE_SPI_TRANSFER, &latency), 0);
+    assert_int_equal(latency.count, 1000);
+    assert_int_equal(latency.total_ns, 500500000);
+    assert_int_equal(latency.max_ns, 1000000);
+    assert_true(latency.p50_ns >= 470000 && latency.p50_ns <= 530000);
+    assert_true(latency.p99_ns >= 930000 && latency.p99_ns <= 1000000);
+    assert_true(latency.p50_ns <= latency.p90_ns);
+    assert_true(latency.p90_ns <= latency.p99_ns);
+    assert_true(latency.p999_ns <= latency.max_ns);
+    assert_int_equal(trace_get_latency(TRACE_POINT_COUNT, &latency), -1);
+
+    system_metrics_t metrics;
+    assert_int_equal(system_get_metrics(&metrics), 0);
+    assert_int_equal(metrics.trace_events, 1000);
+    assert_int_equal(metrics.trace_overwritten, 0);
+    assert_int_equal(metrics.latency[TRACE_SPI_TRANSFER].count, 1000);
+    assert_int_equal(metrics.latency[TRACE_UART_SEND].count, 0);
+    assert_int_equal(system_get_metrics(NULL), -1);
+
+    trace_reset();
+    assert_int_equal(trace_get_latency(TRACE_SPI_TRANSFER, &latency), 0);
+    assert_int_equal(latency.count, 0);
+}
+
+// Test Chrome trace export of the buffered events
+static void* trace_thread(void* arg) {
+    trace_record_ns(TRACE_SPI_TRANSFER, 3000, 100, (uint32_t)(uintptr_t)arg);
+    return NULL;
+}
+
+// Threads in an export: one thread_name metadata row each
+static size_t exported_threads(const char* path) {
+    static char buffer[1 << 16];
+    assert_true(trace_export_chrome(path) >= 0);
+    FILE* in = fopen(path, "r");
+    assert_non_null(in);
+    size_t n = fread(buffer, 1, sizeof(buffer) - 1, in);
+    fclose(in);
+    remove(path);
+    buffer[n] = '\0';
+
+    size_t threads = 0;
+    for (const char* p = buffer; (p = strstr(p, "\"thread_name\"")) != NULL; p++) {
+        threads++;
+    }
+    return threads;
+}
+
+static void test_trace_export(void **state) {
+    (void) state; // unused
+
+    trace_init();
+    trace_reset();
+    trace_record_ns(TRACE_MEMORY_ALLOC, 1000, 250, 64);
+    trace_record_ns(TRACE_PROTOCOL_REQUEST, 2000, 1500, 7);
+
+    const char* path = "test_trace_export.json";
+    assert_int_equal(trace_export_chrome(path), 2);
+
+    // Threads from earlier tests keep their (empty) buffers and metadata rows
+    static char buffer[1 << 16];
+    FILE* in = fopen(path, "r");
+    assert_non_null(in);
+    size_t n = fread(buffer, 1, sizeof(buffer) - 1, in);
+    fclose(in);
+    remove(path);
+    buffer[n] = '\0';
+
+    assert_true(strncmp(buffer, "{\"displayTimeUnit\"", 18) == 0);
+    assert_non_null(strstr(buffer, trace_point_name(TRACE_MEMORY_ALLOC)));
+    assert_non_null(strstr(buffer, trace_point_name(TRACE_PROTOCOL_REQUEST)));
+    assert_int_equal(trace_export_chrome("/nonexistent/dir/trace.json"), -1);
+
+    // A finished thread's buffer goes to the next thread once exported
+    pthread_t thread;
+    pthread_create(&thread, NULL, trace_thread, (void*)1);
+    pthread_join(thread, NULL);
+    size_t threads = exported_threads(path);
+    pthread_create(&thread, NULL, trace_thread, (void*)2);
+    pthread_join(thread, NULL);
+    assert_int_equal(exported_threads(path), threads);
+
+    trace_latency_t latency;
+    assert_int_equal(trace_get_latency(TRACE_SPI_TRANSFER, &latency), 0);
+    assert_int_equal(latency.count, 2);
+
+    trace_reset();
+}
+
 int main(void) {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_system_init),
+        cmocka_unit_test(test_config_snapshot),
         cmocka_unit_test(test_memory_alloc),
         cmocka_unit_test(test_memory_bounds),
+        cmocka_unit_test(test_memory_free_reuse),
+        cmocka_unit_test(test_memory_double_free),
+        cmocka_unit_test(test_memory_steady_state),
+        cmocka_unit_test(test_memory_coalesce),
+        cmocka_unit_test(test_memory_stats),
+        cmocka_unit_test(test_memory_arena),
+        cmocka_unit_test(test_memory_thread_cache),
+        cmocka_unit_test(test_log_ring),
+        cmocka_unit_test(test_protocol_dispatch),
+        cmocka_unit_test(test_protocol_codec),
+        cmocka_unit_test(test_protocol_queue),
+        cmocka_unit_test(test_shm_transport),
+        cmocka_unit_test(test_shm_transport_writers),
+        cmocka_unit_test(test_scheduler),
+        cmocka_unit_test(test_trace_latency),
+        cmocka_unit_test(test_trace_export),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
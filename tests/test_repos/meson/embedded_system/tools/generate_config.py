@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""
+Config snapshot generator - demonstrates Meson custom_target()
+
+Compiles the JSON system config into a const system_config_t that is
+linked into libcore, so boot reads config without parsing or allocating.
+"""
+
+import json
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+# Must match SYSTEM_CONFIG_MAGIC / SYSTEM_CONFIG_VERSION in core/system.h
+CONFIG_MAGIC = 0x46435345  # "ESCF"
+CONFIG_VERSION = 1
+CONFIG_SIZE = 16
+
+# JSON key -> (default, validator)
+FIELDS = {
+    "debug_mode": (False, lambda value: isinstance(value, bool)),
+}
+
+
+def load_config(path: Path) -> dict:
+    config = json.loads(path.read_text())
+    if not isinstance(config, dict):
+        raise ValueError("config must be a JSON object")
+
+    unknown = sorted(set(config) - set(FIELDS))
+    if unknown:
+        raise ValueError(f"unknown config keys: {', '.join(unknown)}")
+
+    values = {}
+    for key, (default, valid) in FIELDS.items():
+        value = config.get(key, default)
+        if not valid(value):
+            raise ValueError(f"invalid value for {key}: {value!r}")
+        values[key] = value
+    return values
+
+
+def checksum(values: dict) -> int:
+    """CRC-32 over the little-endian encoding of every field before checksum"""
+    packed = struct.pack("<IHHB3x", CONFIG_MAGIC, CONFIG_VERSION, CONFIG_SIZE,
+                         1 if values["debug_mode"] else 0)
+    return zlib.crc32(packed) & 0xFFFFFFFF
+
+
+def generate_snapshot_c(source: str, values: dict) -> str:
+    return f"""/* GENERATED FILE - DO NOT EDIT */
+/* Generated from {source} */
+
+#include "system.h"
+
+const system_config_t system_config_snapshot = {{
+    .magic = 0x{CONFIG_MAGIC:08X}u,
+    .version = {CONFIG_VERSION},
+    .size = {CONFIG_SIZE},
+    .debug_mode = {1 if values["debug_mode"] else 0},
+    .checksum = 0x{checksum(values):08X}u,
+}};
+"""
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(f"Usage: {sys.argv[0]} <config.json> <output.c>")
+        sys.exit(1)
+
+    input_file = Path(sys.argv[1])
+    output_c = Path(sys.argv[2])
+
+    try:
+        values = load_config(input_file)
+    except ValueError as error:
+        print(f"{input_file}: {error}", file=sys.stderr)
+        sys.exit(1)
+
+    output_c.write_text(generate_snapshot_c(input_file.name, values))
+    print(f"Generated: {output_c}")
+
+
+if __name__ == "__main__":
+    main()
@@ -2,68 +2,562 @@
 """
 Protocol code generator - demonstrates Meson custom_target()
 
-Reads a .proto file and generates C code for protocol handlers.
+Reads a .proto file and generates C code for protocol handlers, plus a
+protobuf wire-format codec for every message it declares.
 """
 
+import re
 import sys
 from pathlib import Path
 
 
-def generate_protocol_c(proto_content: str) -> str:
-    """Generate protocol_generated.c file"""
-    return f"""/* GENERATED FILE - DO NOT EDIT */
-/* Generated from protocol.proto */
+# proto scalar type -> (C type, wire encoding)
+SCALAR_TYPES = {
+    "uint32": ("uint32_t", "varint"),
+    "uint64": ("uint64_t", "varint"),
+    "int32": ("int32_t", "varint"),
+    "int64": ("int64_t", "varint"),
+    "bool": ("bool", "varint"),
+    "sint32": ("int32_t", "zigzag"),
+    "sint64": ("int64_t", "zigzag"),
+    "fixed32": ("uint32_t", "fixed32"),
+    "sfixed32": ("int32_t", "fixed32"),
+    "float": ("float", "fixed32"),
+    "fixed64": ("uint64_t", "fixed64"),
+    "sfixed64": ("int64_t", "fixed64"),
+    "double": ("double", "fixed64"),
+    "string": ("proto_view_t", "view"),
+    "bytes": ("proto_view_t", "view"),
+}
 
-#include "protocol_generated.h"
-#include <stdio.h>
-#include <string.h>
+WIRE_TYPES = {"varint": 0, "zigzag": 0, "fixed64": 1, "view": 2, "fixed32": 5}
 
-void protocol_generated_init(void) {{
-    printf("Protocol handlers initialized\\n");
+
+def strip_comments(proto_content: str) -> str:
+    return re.sub(r"//[^\n]*", "", proto_content)
+
+
+def parse_message_types(proto_content: str) -> list:
+    """Return (name, value) pairs from the MessageType enum, sorted by value"""
+    match = re.search(r"enum\s+MessageType\s*\{([^}]*)\}", strip_comments(proto_content))
+    if not match:
+        raise ValueError("protocol.proto has no MessageType enum")
+
+    entries = re.findall(r"(\w+)\s*=\s*(\d+)\s*;", match.group(1))
+    types = sorted(((name, int(value)) for name, value in entries), key=lambda entry: entry[1])
+
+    values = [value for _, value in types]
+    if len(set(values)) != len(values):
+        raise ValueError("MessageType values must be unique")
+    return types
+
+
+def parse_messages(proto_content: str) -> list:
+    """Return [(name, [field, ...])] for each top-level message, in order.
+
+    A field is a dict with name, number, proto type, C type, encoding and
+    the oneof it belongs to (or None).
+    """
+    content = strip_comments(proto_content)
+    enums = set(re.findall(r"enum\s+(\w+)\s*\{", content))
+    names = re.findall(r"message\s+(\w+)\s*\{", content)
+
+    messages = []
+    for match in re.finditer(r"message\s+(\w+)\s*\{", content):
+        depth, pos = 1, match.end()
+        while depth:
+            if pos >= len(content):
+                raise ValueError(f"message {match.group(1)} is not closed")
+            depth += {"{": 1, "}": -1}.get(content[pos], 0)
+            pos += 1
+        body = content[match.end():pos - 1]
+
+        declared = []
+        for oneof in re.finditer(r"oneof\s+(\w+)\s*\{([^}]*)\}", body):
+            declared += [(oneof.group(1), f) for f in re.finditer(r"([\w ]+?)\s+(\w+)\s*=\s*(\d+)\s*;", oneof.group(2))]
+        plain = re.sub(r"oneof\s+\w+\s*\{[^}]*\}", "", body)
+        declared += [(None, f) for f in re.finditer(r"([\w ]+?)\s+(\w+)\s*=\s*(\d+)\s*;", plain)]
+
+        fields = []
+        for oneof, field in declared:
+            proto_type = field.group(1).split()
+            if len(proto_type) != 1:
+                raise ValueError(f"{match.group(1)}.{field.group(2)}: only singular fields are supported")
+            proto_type = proto_type[0]
+
+            if proto_type in SCALAR_TYPES:
+                c_type, encoding = SCALAR_TYPES[proto_type]
+            elif proto_type in enums:
+                c_type = "message_type_t" if proto_type == "MessageType" else "int32_t"
+                encoding = "varint"
+            elif proto_type in names:
+                # Sub-messages stay encoded; decode them on demand from the view
+                c_type, encoding = "proto_view_t", "view"
+            else:
+                raise ValueError(f"{match.group(1)}.{field.group(2)}: unknown type {proto_type}")
+
+            fields.append({
+                "name": field.group(2),
+                "number": int(field.group(3)),
+                "proto_type": proto_type,
+                "c_type": c_type,
+                "encoding": encoding,
+                "oneof": oneof,
+            })
+        fields.sort(key=lambda f: f["number"])
+        messages.append((match.group(1), fields))
+    return messages
+
+
+def snake_case(name: str) -> str:
+    return re.sub(r"(?<!^)(?=[A-Z])", "_", name).lower()
+
+
+def handler_name(name: str) -> str:
+    return f"protocol_generated_handle_{name.lower()}"
+
+
+def oneofs(fields: list) -> list:
+    seen = []
+    for field in fields:
+        if field["oneof"] and field["oneof"] not in seen:
+            seen.append(field["oneof"])
+    return seen
+
+
+def field_present(field: dict) -> str:
+    """C condition under which proto3 puts the field on the wire"""
+    name = field["name"]
+    if field["oneof"]:
+        return f"msg->{field['oneof']}_case == {field['number']}"
+    if field["encoding"] == "view":
+        return f"msg->{name}.size != 0"
+    if field["c_type"] in ("float", "double"):
+        return f"msg->{name} != 0"
+    return f"msg->{name}"
+
+
+def wire_value(field: dict) -> str:
+    """C expression for the field's raw wire value (varint or fixed)"""
+    value = f"msg->{field['name']}"
+    encoding, c_type = field["encoding"], field["c_type"]
+    if encoding == "zigzag":
+        return f"zigzag_encode({value})"
+    if encoding == "varint":
+        if c_type in ("int32_t", "int64_t", "message_type_t"):
+            # Negative values are sign-extended to ten bytes, as protobuf does
+            return f"(uint64_t)(int64_t){value}"
+        if c_type == "bool":
+            return f"(uint64_t)({value} ? 1 : 0)"
+        return f"(uint64_t){value}"
+    if c_type == "float":
+        return f"float_bits({value})"
+    if c_type == "double":
+        return f"double_bits({value})"
+    return f"(uint64_t){value}" if encoding == "fixed64" else f"(uint32_t){value}"
+
+
+def tag_value(field: dict) -> int:
+    return (field["number"] << 3) | WIRE_TYPES[field["encoding"]]
+
+
+def generate_codec_c(name: str, fields: list) -> str:
+    prefix = f"proto_{snake_case(name)}"
+    size_lines, encode_lines, decode_cases = [], [], []
+
+    for field in fields:
+        tag = tag_value(field)
+        tag_size = len(encode_varint(tag))
+        present = field_present(field)
+        encoding = field["encoding"]
+        member = f"msg->{field['name']}"
+
+        if encoding == "view":
+            size_lines.append(f"    if ({present}) {{\n"
+                              f"        size += {tag_size} + varint_size({member}.size) + {member}.size;\n"
+                              f"    }}")
+            encode_lines.append(f"    if ({present}) {{\n"
+                                f"        p = put_varint(p, {tag}u);\n"
+                                f"        p = put_varint(p, {member}.size);\n"
+                                f"        if ({member}.size) {{\n"
+                                f"            memcpy(p, {member}.data, {member}.size);\n"
+                                f"        }}\n"
+                                f"        p += {member}.size;\n"
+                                f"    }}")
+            read = f"if (get_view(&p, end, &{member}) != 0) {{\n                return -1;\n            }}"
+        elif encoding in ("varint", "zigzag"):
+            size_lines.append(f"    if ({present}) {{\n"
+                              f"        size += {tag_size} + varint_size({wire_value(field)});\n"
+                              f"    }}")
+            encode_lines.append(f"    if ({present}) {{\n"
+                                f"        p = put_varint(p, {tag}u);\n"
+                                f"        p = put_varint(p, {wire_value(field)});\n"
+                                f"    }}")
+            if encoding == "zigzag":
+                convert = f"({field['c_type']})zigzag_decode(value)"
+            elif field["c_type"] == "bool":
+                convert = "value != 0"
+            else:
+                convert = f"({field['c_type']})value"
+            read = (f"if (get_varint(&p, end, &value) != 0) {{\n                return -1;\n            }}\n"
+                    f"            {member} = {convert};")
+        else:
+            width = 4 if encoding == "fixed32" else 8
+            size_lines.append(f"    if ({present}) {{\n        size += {tag_size} + {width};\n    }}")
+            encode_lines.append(f"    if ({present}) {{\n"
+                                f"        p = put_varint(p, {tag}u);\n"
+                                f"        p = put_{encoding}(p, {wire_value(field)});\n"
+                                f"    }}")
+            if field["c_type"] == "float":
+                convert = "float_from_bits((uint32_t)value)"
+            elif field["c_type"] == "double":
+                convert = "double_from_bits(value)"
+            else:
+                convert = f"({field['c_type']})value"
+            read = (f"if (get_{encoding}(&p, end, &value) != 0) {{\n                return -1;\n            }}\n"
+                    f"            {member} = {convert};")
+
+        if field["oneof"]:
+            read += f"\n            msg->{field['oneof']}_case = {field['number']};"
+        decode_cases.append(f"        case {field['number']}:\n"
+                            f"            if (wire_type != {WIRE_TYPES[encoding]}) {{\n                return -1;\n            }}\n"
+                            f"            {read}\n"
+                            f"            break;")
+
+    size_body = "\n".join(size_lines)
+    encode_body = "\n".join(encode_lines)
+    cases = "\n".join(decode_cases)
+    return f"""
+size_t {prefix}_encoded_size(const {prefix}_t* msg) {{
+    size_t size = 0;
+{size_body}
+    return size;
 }}
 
-int protocol_generated_handle_request(uint32_t id, const uint8_t* payload, size_t size) {{
-    printf("Handling request: id=%u, size=%zu\\n", id, size);
-    // Generated handler code would go here
-    return 0;
+int {prefix}_encode(const {prefix}_t* msg, uint8_t* buffer, size_t capacity) {{
+    size_t size = {prefix}_encoded_size(msg);
+    if (size > capacity || size > INT_MAX) {{
+        return -1;
+    }}
+
+    uint8_t* p = buffer;
+{encode_body}
+    return (int)size;
 }}
 
-int protocol_generated_handle_response(uint32_t id, const uint8_t* payload, size_t size) {{
-    printf("Handling response: id=%u, size=%zu\\n", id, size);
-    // Generated handler code would go here
+int {prefix}_decode({prefix}_t* msg, const uint8_t* buffer, size_t length) {{
+    memset(msg, 0, sizeof(*msg));
+    if (length == 0) {{
+        return 0;
+    }}
+
+    const uint8_t* p = buffer;
+    const uint8_t* end = buffer + length;
+    while (p < end) {{
+        uint64_t value;
+        if (get_varint(&p, end, &value) != 0 || (value >> 3) == 0 || (value >> 3) > UINT32_MAX) {{
+            return -1;
+        }}
+        uint32_t wire_type = (uint32_t)(value & 7);
+
+        switch ((uint32_t)(value >> 3)) {{
+{cases}
+        default:
+            if (skip_field(&p, end, wire_type) != 0) {{
+                return -1;
+            }}
+            break;
+        }}
+    }}
     return 0;
 }}
+"""
+
+
+def encode_varint(value: int) -> bytes:
+    out = bytearray()
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+# Wire-format primitives shared by every generated codec; inline so the
+# ones a given .proto never needs do not trip -Wunused-function
+CODEC_RUNTIME = r"""
+static inline size_t varint_size(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
 
-int protocol_generated_handle_event(uint32_t id, const uint8_t* payload, size_t size) {{
-    printf("Handling event: id=%u, size=%zu\\n", id, size);
+static inline uint8_t* put_varint(uint8_t* p, uint64_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+static inline uint8_t* put_fixed32(uint8_t* p, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        *p++ = (uint8_t)(value >> (8 * i));
+    }
+    return p;
+}
+
+static inline uint8_t* put_fixed64(uint8_t* p, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        *p++ = (uint8_t)(value >> (8 * i));
+    }
+    return p;
+}
+
+static inline int get_varint(const uint8_t** p, const uint8_t* end, uint64_t* value) {
+    const uint8_t* q = *p;
+    if (q < end && *q < 0x80) {
+        *value = *q;
+        *p = q + 1;
+        return 0;
+    }
+
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < 64 && q < end; shift += 7) {
+        uint8_t byte = *q++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            *value = result;
+            *p = q;
+            return 0;
+        }
+    }
+    return -1;  // Truncated, or longer than ten bytes
+}
+
+static inline int get_fixed32(const uint8_t** p, const uint8_t* end, uint64_t* value) {
+    if (end - *p < 4) {
+        return -1;
+    }
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        result |= (uint32_t)(*p)[i] << (8 * i);
+    }
+    *value = result;
+    *p += 4;
+    return 0;
+}
+
+static inline int get_fixed64(const uint8_t** p, const uint8_t* end, uint64_t* value) {
+    if (end - *p < 8) {
+        return -1;
+    }
+    uint64_t result = 0;
+    for (int i = 0; i < 8; i++) {
+        result |= (uint64_t)(*p)[i] << (8 * i);
+    }
+    *value = result;
+    *p += 8;
+    return 0;
+}
+
+// Length-delimited field: the view aliases the input buffer, nothing is copied
+static inline int get_view(const uint8_t** p, const uint8_t* end, proto_view_t* view) {
+    uint64_t length;
+    if (get_varint(p, end, &length) != 0 || length > (uint64_t)(end - *p)) {
+        return -1;
+    }
+    view->data = *p;
+    view->size = (size_t)length;
+    *p += length;
+    return 0;
+}
+
+static inline int skip_field(const uint8_t** p, const uint8_t* end, uint32_t wire_type) {
+    uint64_t value;
+    proto_view_t view;
+    switch (wire_type) {
+        case 0: return get_varint(p, end, &value);
+        case 1: return get_fixed64(p, end, &value);
+        case 2: return get_view(p, end, &view);
+        case 5: return get_fixed32(p, end, &value);
+        default: return -1;
+    }
+}
+
+static inline uint64_t zigzag_encode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t zigzag_decode(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static inline uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float float_from_bits(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline uint64_t double_bits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline double double_from_bits(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+"""
+
+
+def message_for_type(type_name: str, messages: list):
+    """Message carried by a MessageType value, matched by name (REQUEST -> Request)"""
+    for name, _ in messages:
+        if name.lower() == type_name.lower():
+            return name
+    return None
+
+
+def generate_protocol_c(proto_content: str) -> str:
+    """Generate protocol_generated.c file"""
+    types = parse_message_types(proto_content)
+    messages = parse_messages(proto_content)
+    handled = [(name, value) for name, value in types if value != 0]
+    count = types[-1][1] + 1
+
+    codecs = "".join(generate_codec_c(name, fields) for name, fields in messages)
+
+    handlers = ""
+    for name, _ in handled:
+        message = message_for_type(name, messages)
+        if message:
+            prefix = f"proto_{snake_case(message)}"
+            body = f"""    {prefix}_t msg;
+    if ({prefix}_decode(&msg, payload, size) != 0) {{
+        LOG_WARN("Malformed {name.lower()}: id=%u, size=%zu", id, size);
+        return -1;
+    }}
+    LOG_DEBUG("Handling {name.lower()}: id=%u, size=%zu", id, size);"""
+        else:
+            body = f"""    (void)payload;
+    LOG_DEBUG("Handling {name.lower()}: id=%u, size=%zu", id, size);"""
+        handlers += f"""
+int {handler_name(name)}(uint32_t id, const uint8_t* payload, size_t size) {{
+{body}
     // Generated handler code would go here
     return 0;
 }}
+"""
+
+    slots = {value: name for name, value in handled}
+    table = ""
+    for value in range(count):
+        entry = handler_name(slots[value]) if value in slots else "NULL"
+        table += f"    [{value}] = {entry},\n"
+
+    return f"""/* GENERATED FILE - DO NOT EDIT */
+/* Generated from protocol.proto */
+
+#include "protocol_generated.h"
+#include "core/log.h"
+#include <limits.h>
+#include <string.h>
+{CODEC_RUNTIME}{codecs}
+void protocol_generated_init(void) {{
+    LOG_INFO("Protocol handlers initialized");
+}}
+{handlers}
+// Default dispatch table, indexed by message_type_t
+const protocol_handler_fn protocol_generated_handlers[PROTOCOL_MESSAGE_TYPE_COUNT] = {{
+{table}}};
 
 void protocol_generated_cleanup(void) {{
-    printf("Protocol handlers cleaned up\\n");
+    LOG_INFO("Protocol handlers cleaned up");
 }}
 """
 
 
+def generate_codec_h(name: str, fields: list) -> str:
+    prefix = f"proto_{snake_case(name)}"
+    members = "\n".join(f"    {f['c_type']} {f['name']};" for f in fields)
+    for oneof in oneofs(fields):
+        members += f"\n    uint32_t {oneof}_case;  // Field number of the {oneof} member set, 0 if none"
+    return f"""
+// {name}
+typedef struct {{
+{members}
+}} {prefix}_t;
+
+size_t {prefix}_encoded_size(const {prefix}_t* msg);
+int {prefix}_encode(const {prefix}_t* msg, uint8_t* buffer, size_t capacity);
+int {prefix}_decode({prefix}_t* msg, const uint8_t* buffer, size_t length);
+"""
+
+
 def generate_protocol_h(proto_content: str) -> str:
     """Generate protocol_generated.h file"""
+    types = parse_message_types(proto_content)
+    messages = parse_messages(proto_content)
+    count = types[-1][1] + 1
+
+    enum_entries = ",\n".join(f"    MSG_TYPE_{name} = {value}" for name, value in types)
+    prototypes = "\n".join(
+        f"int {handler_name(name)}(uint32_t id, const uint8_t* payload, size_t size);"
+        for name, value in types if value != 0)
+    codecs = "".join(generate_codec_h(name, fields) for name, fields in messages)
+
     return f"""/* GENERATED FILE - DO NOT EDIT */
 /* Generated from protocol.proto */
 
 #ifndef PROTOCOL_GENERATED_H
 #define PROTOCOL_GENERATED_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
+// Protocol message types
+typedef enum {{
+{enum_entries}
+}} message_type_t;
+
+#define PROTOCOL_MESSAGE_TYPE_COUNT {count}
+
+// Borrowed bytes: string, bytes and sub-message fields point into the
+// buffer they were decoded from, which must outlive the decoded struct
+typedef struct {{
+    const uint8_t* data;
+    size_t size;
+}} proto_view_t;
+
+// Message codecs (protobuf wire format). encode() returns the bytes
+// written or -1 if the buffer is too small; decode() returns 0 or -1 on
+// malformed input and never allocates.
+{codecs}
+// Message handler signature
+typedef int (*protocol_handler_fn)(uint32_t id, const uint8_t* payload, size_t size);
+
 // Initialize generated protocol handlers
 void protocol_generated_init(void);
 
-// Generated message handlers
-int protocol_generated_handle_request(uint32_t id, const uint8_t* payload, size_t size);
-int protocol_generated_handle_response(uint32_t id, const uint8_t* payload, size_t size);
-int protocol_generated_handle_event(uint32_t id, const uint8_t* payload, size_t size);
+// Generated message handlers; each decodes its payload with the matching codec
+{prototypes}
+
+// Default handler per message type; NULL where a type has no handler
+extern const protocol_handler_fn protocol_generated_handlers[PROTOCOL_MESSAGE_TYPE_COUNT];
 
 // Cleanup
 void protocol_generated_cleanup(void);
@@ -83,6 +577,12 @@ def main():
 
     # Read protocol definition
     proto_content = input_file.read_text()
+    try:
+        parse_message_types(proto_content)
+        parse_messages(proto_content)
+    except ValueError as error:
+        print(f"{input_file}: {error}", file=sys.stderr)
+        sys.exit(1)
 
     # Generate C file
     c_code = generate_protocol_c(proto_content)